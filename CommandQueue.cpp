@@ -0,0 +1,143 @@
+#include "CommandQueue.h"
+
+std::atomic<unsigned long> CommandStats::updates(0);
+std::atomic<unsigned long> CommandStats::merged(0);
+std::atomic<unsigned long> CommandStats::maxBacklog(0);
+
+CommandIndex::CommandIndex(std::size_t size)
+    : mask(1)
+{
+    while(mask < size) mask <<= 1;
+    entries.reset(new Entry[mask]);
+    for(std::size_t i = 0; i < mask; i++)
+        entries[i] = Entry{nullptr, Property::None, npos};
+    mask--;
+}
+
+std::size_t CommandIndex::hash(const void *target, Property property) const
+{
+    std::uint64_t h = (reinterpret_cast<std::uintptr_t>(target) >> 3) ^ (static_cast<std::uint64_t>(property) << 56);
+    return static_cast<std::size_t>((h * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+}
+
+std::size_t CommandIndex::find(const void *target, Property property, std::size_t minPos) const
+{
+    std::size_t i = hash(target, property);
+    for(std::size_t n = 0; n < maxProbes; n++, i = (i + 1) & mask)
+    {
+        const Entry &e = entries[i];
+        // (entries are never emptied, so the key can't be further)
+        if(e.pos == npos) break;
+        if(e.target == target && e.property == property)
+            return e.pos >= minPos ? e.pos : npos;
+    }
+    return npos;
+}
+
+std::size_t CommandIndex::exchange(const void *target, Property property, std::size_t pos, std::size_t minPos, bool *recorded)
+{
+    if(recorded) *recorded = true;
+    Entry *free = nullptr;
+    std::size_t i = hash(target, property);
+    for(std::size_t n = 0; n < maxProbes; n++, i = (i + 1) & mask)
+    {
+        Entry &e = entries[i];
+        if(e.target == target && e.property == property && e.pos != npos)
+        {
+            std::size_t prev = e.pos >= minPos ? e.pos : npos;
+            e.pos = pos;
+            return prev;
+        }
+        bool empty = e.pos == npos;
+        if(!free && (empty || e.pos < minPos)) free = &e;
+        if(empty) break;
+    }
+    if(free) *free = Entry{target, property, pos};
+    else if(recorded) *recorded = false;
+    return npos;
+}
+
+CommandBatch::CommandBatch()
+    : lastUpdate(1024),
+      base(0)
+{
+}
+
+void CommandBatch::push(Command &&cmd)
+{
+    if(cmd.property != Property::None)
+    {
+        CommandStats::updates++;
+
+        // last writer wins: the previous update of the same property is
+        // cancelled, and the new one is executed in its own position (so
+        // that it is still ordered with respect to any command in between)
+        std::size_t prev = lastUpdate.exchange(cmd.target, cmd.property, base + commands.size(), base);
+        if(prev != CommandIndex::npos)
+        {
+            commands[prev - base].run.reset();
+            CommandStats::merged++;
+        }
+    }
+
+    commands.push_back(std::move(cmd));
+}
+
+void CommandBatch::take(std::deque<Command> &cmds)
+{
+    base += commands.size();
+    cmds.swap(commands);
+    commands.clear();
+}
+
+CommandRing::CommandRing(std::size_t capacity_)
+    : capacity(1),
+      head(0),
+      tail(0),
+      wakeUpPending(false),
+      lastUpdate(4 * capacity_)
+{
+    while(capacity < capacity_) capacity <<= 1;
+    mask = capacity - 1;
+    slots.reset(new Slot[capacity]);
+    for(std::size_t i = 0; i < capacity; i++)
+        slots[i].cancelled = false;
+}
+
+bool CommandRing::push(Command &cmd)
+{
+    std::size_t h = head.load(std::memory_order_relaxed);
+    std::size_t t = tail.load(std::memory_order_acquire);
+    if(h - t >= capacity) return false;
+
+    if(cmd.property != Property::None)
+    {
+        CommandStats::updates++;
+
+        // last writer wins (see CommandBatch::push); the previous update can
+        // be cancelled only if the consumer has not got to it yet (if it is
+        // being executed right now, both are executed, which is fine too;
+        // the same if the update could not be recorded)
+        std::size_t prev = lastUpdate.exchange(cmd.target, cmd.property, h, t);
+        if(prev != CommandIndex::npos)
+        {
+            slots[prev & mask].cancelled.store(true, std::memory_order_relaxed);
+            CommandStats::merged++;
+        }
+    }
+
+    Slot &slot = slots[h & mask];
+    slot.cmd = std::move(cmd);
+    slot.cancelled.store(false, std::memory_order_relaxed);
+    head.store(h + 1);
+
+    if(h + 1 - t > CommandStats::maxBacklog)
+        CommandStats::maxBacklog = h + 1 - t;
+
+    return true;
+}
+
+bool CommandRing::requestWakeUp()
+{
+    return !wakeUpPending.exchange(true);
+}
@@ -0,0 +1,368 @@
+#ifndef COMMANDQUEUE_H_INCLUDED
+#define COMMANDQUEUE_H_INCLUDED
+
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "widgets/Widget.h"
+#include "widgets/Window.h"
+
+/**
+ * properties of a widget (or window) which are entirely replaced by a setter;
+ * pending updates of the same property of the same target can be merged,
+ * keeping only the last one
+ */
+enum class Property
+{
+    None = 0, // not mergeable
+    StyleSheet,
+    Enabled,
+    Visibility,
+    Text,
+    Value,
+    CurrentIndex,
+    Url,
+    Title,
+    Position,
+    Size,
+    PlotRanges,
+    PlotXRange,
+    PlotYRange,
+    Image
+};
+
+/**
+ * a type-erased callable (like std::function<void()>), which stores the callable
+ * object inline, so that no heap allocation is needed for the typical bound
+ * UI slot call; larger callables are stored on the heap
+ */
+class CommandFunction
+{
+public:
+    static const std::size_t inlineSize = 128;
+
+    CommandFunction() : invoke(nullptr), manage(nullptr) {}
+
+    template<typename F, typename = typename std::enable_if<!std::is_same<typename std::decay<F>::type, CommandFunction>::value>::type>
+    CommandFunction(F &&f) : invoke(nullptr), manage(nullptr)
+    {
+        typedef typename std::decay<F>::type Fn;
+        store<Fn>(std::forward<F>(f), std::integral_constant<bool, sizeof(Fn) <= inlineSize && alignof(Fn) <= alignof(std::max_align_t)>());
+    }
+
+    CommandFunction(CommandFunction &&o) : invoke(nullptr), manage(nullptr)
+    {
+        *this = std::move(o);
+    }
+
+    CommandFunction & operator=(CommandFunction &&o)
+    {
+        if(this == &o) return *this;
+        reset();
+        if(o.manage)
+        {
+            o.manage(Move, o.storage, storage);
+            invoke = o.invoke;
+            manage = o.manage;
+            o.invoke = nullptr;
+            o.manage = nullptr;
+        }
+        return *this;
+    }
+
+    CommandFunction(const CommandFunction &) = delete;
+    CommandFunction & operator=(const CommandFunction &) = delete;
+
+    ~CommandFunction()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        if(manage) manage(Destroy, storage, nullptr);
+        invoke = nullptr;
+        manage = nullptr;
+    }
+
+    explicit operator bool() const {return invoke != nullptr;}
+
+    void operator()() {invoke(storage);}
+
+private:
+    enum Op {Move, Destroy};
+
+    template<typename Fn, typename F>
+    void store(F &&f, std::true_type /* fits inline */)
+    {
+        new (storage) Fn(std::forward<F>(f));
+        invoke = &invokeInline<Fn>;
+        manage = &manageInline<Fn>;
+    }
+
+    template<typename Fn, typename F>
+    void store(F &&f, std::false_type /* fits inline */)
+    {
+        *reinterpret_cast<Fn**>(storage) = new Fn(std::forward<F>(f));
+        invoke = &invokeHeap<Fn>;
+        manage = &manageHeap<Fn>;
+    }
+
+    template<typename Fn>
+    static void invokeInline(void *p)
+    {
+        (*static_cast<Fn*>(p))();
+    }
+
+    template<typename Fn>
+    static void manageInline(Op op, void *src, void *dst)
+    {
+        Fn *f = static_cast<Fn*>(src);
+        if(op == Move) new (dst) Fn(std::move(*f));
+        f->~Fn();
+    }
+
+    template<typename Fn>
+    static void invokeHeap(void *p)
+    {
+        (**static_cast<Fn**>(p))();
+    }
+
+    template<typename Fn>
+    static void manageHeap(Op op, void *src, void *dst)
+    {
+        Fn **f = static_cast<Fn**>(src);
+        if(op == Move) *static_cast<Fn**>(dst) = *f;
+        else delete *f;
+    }
+
+    void (*invoke)(void *);
+    void (*manage)(Op, void *, void *);
+    alignas(std::max_align_t) unsigned char storage[inlineSize];
+};
+
+/**
+ * a large argument of a command (e.g. plot points, table item image data),
+ * moved out of the stub input and then shared, rather than copied, by the
+ * command and the UI slot
+ */
+template<typename T>
+using Payload = std::shared_ptr<const T>;
+
+template<typename T>
+Payload<typename std::decay<T>::type> makePayload(T &&t)
+{
+    return std::make_shared<const typename std::decay<T>::type>(std::forward<T>(t));
+}
+
+/**
+ * a deferred call of a UI slot, as enqueued by SIM and executed in the UI thread
+ */
+struct Command
+{
+    // the target widget (0 if the command targets a Window, see window); used
+    // to discard commands whose widget has been deleted in the meantime
+    WidgetRef widget;
+
+    // the target (Widget or Window) and the property it modifies, used for merging:
+    const void *target;
+    Property property;
+
+    // the name of the UI slot (see UI_SLOT), used for the statistics:
+    const char *name;
+
+    // bulk data (e.g. plot points, image frames), executed after the other
+    // commands (see SIM::callBulk)
+    bool bulk;
+
+    // empty if the command has been superseded by a later one
+    CommandFunction run;
+
+    // set by SIM::enqueue if the statistics are enabled (see simUI.getStats):
+    std::chrono::steady_clock::time_point enqueued;
+
+    // the mirrorSeq of the target widget when the command was enqueued (see
+    // Widget::mirrorSeq):
+    quint32 mirrorSeq;
+
+    // the target window (0 if the command targets a Widget); used to discard
+    // commands whose window has been deleted in the meantime
+    WindowRef window;
+};
+
+/**
+ * number of mergeable updates issued, and of those discarded because
+ * superseded by a later update of the same property (see simUI.getCoalescingStats)
+ */
+struct CommandStats
+{
+    static std::atomic<unsigned long> updates;
+    static std::atomic<unsigned long> merged;
+
+    // highest number of commands waiting in the ring (see simUI.getCommandBacklog)
+    static std::atomic<unsigned long> maxBacklog;
+};
+
+/**
+ * (target, property) -> position of the last command for it, in a fixed-size
+ * open-addressing table, so that recording a command does not allocate;
+ * positions only increase, and an entry whose position is before the given
+ * minimum position (e.g. a command which has been consumed already) has
+ * expired and can be reused; not thread-safe
+ */
+class CommandIndex
+{
+public:
+    static const std::size_t npos = std::size_t(-1);
+
+    explicit CommandIndex(std::size_t size);
+
+    // position of the last command for (target, property), or npos if none
+    // has been recorded at or after minPos:
+    std::size_t find(const void *target, Property property, std::size_t minPos) const;
+
+    // records pos as the position of the last command for (target, property),
+    // and returns the previous one (see find); if there is no room left
+    // around the key, nothing is recorded, and recorded is set to false
+    std::size_t exchange(const void *target, Property property, std::size_t pos, std::size_t minPos, bool *recorded = nullptr);
+
+private:
+    struct Entry
+    {
+        const void *target;
+        Property property;
+        std::size_t pos; // npos if never used
+    };
+
+    // number of entries looked at for a key:
+    static const std::size_t maxProbes = 8;
+
+    std::size_t hash(const void *target, Property property) const;
+
+    std::unique_ptr<Entry[]> entries;
+    std::size_t mask;
+};
+
+/**
+ * a list of commands recorded by the SIM thread (see simUI.beginBatch),
+ * with last-writer-wins merging of updates; not thread-safe
+ */
+class CommandBatch
+{
+public:
+    CommandBatch();
+
+    void push(Command &&cmd);
+
+    // moves all the recorded commands into cmds
+    void take(std::deque<Command> &cmds);
+
+    inline bool empty() {return commands.empty();}
+
+private:
+    std::deque<Command> commands;
+
+    // (target, property) -> base + index in commands of the last update (the
+    // entries of the previous batches have expired, see take):
+    CommandIndex lastUpdate;
+    std::size_t base;
+};
+
+/**
+ * a lock-free single-producer (SIM thread) single-consumer (UI thread) ring
+ * of preallocated command slots, with last-writer-wins merging of pending
+ * updates
+ */
+class CommandRing
+{
+public:
+    explicit CommandRing(std::size_t capacity = 1024);
+
+    // (producer) moves cmd into the ring; returns false if the ring is full
+    bool push(Command &cmd);
+
+    // (producer) returns true if the consumer must be notified of new commands,
+    // i.e. if no notification is pending already
+    bool requestWakeUp();
+
+    // (producer) sequence number of the next command pushed
+    std::size_t nextSequence() const {return head.load(std::memory_order_relaxed);}
+
+    // (any thread) true if the command with the given sequence number has not
+    // been consumed yet
+    bool isPending(std::size_t seq) const {return seq >= tail.load();}
+
+    // (any thread) sequence number of the first command not yet consumed
+    std::size_t firstPending() const {return tail.load();}
+
+    // (any thread) number of commands not yet consumed
+    std::size_t size() const
+    {
+        std::size_t t = tail.load();
+        return head.load() - t;
+    }
+
+    // (consumer) calls f on each pending (not superseded) command, in order,
+    // stopping at the given deadline; returns false if some commands are left
+    //
+    // a command may run a nested event loop, and so a nested consume (e.g.
+    // onFlushCommands, for a blocking call); each command is moved out of its
+    // slot before being executed, so that the nested call picks up the
+    // following commands, and returns only once they have all been executed
+    template<typename F>
+    bool consume(F f, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max())
+    {
+        wakeUpPending = false;
+
+        bool timed = deadline != std::chrono::steady_clock::time_point::max();
+
+        for(;;)
+        {
+            std::size_t t = tail.load(std::memory_order_relaxed);
+            if(t == head.load())
+                return true;
+
+            if(timed && std::chrono::steady_clock::now() >= deadline)
+                return false;
+
+            Slot &slot = slots[t & mask];
+            bool cancelled = slot.cancelled.load(std::memory_order_relaxed);
+            Command cmd(std::move(slot.cmd));
+            tail.store(t + 1, std::memory_order_release);
+
+            if(!cancelled)
+                f(cmd);
+        }
+    }
+
+private:
+    struct Slot
+    {
+        Command cmd;
+        std::atomic<bool> cancelled;
+    };
+
+    std::size_t capacity;
+    std::size_t mask;
+    std::unique_ptr<Slot[]> slots;
+
+    // sequence numbers of the next slot to write (producer) and read (consumer):
+    std::atomic<std::size_t> head;
+    std::atomic<std::size_t> tail;
+
+    std::atomic<bool> wakeUpPending;
+
+    // (producer only) (target, property) -> sequence number of the last update
+    CommandIndex lastUpdate;
+};
+
+#endif // COMMANDQUEUE_H_INCLUDED
@@ -1,5 +1,6 @@
 #include "Proxy.h"
 
+#include <algorithm>
 #include <vector>
 #include <map>
 #include <iostream>
@@ -9,14 +10,74 @@
 
 #include <simPlusPlus/Lib.h>
 
+void WidgetIndex::insert(int id, Widget *widget)
+{
+    Range &r = range(id);
+    if(r.widgets.empty())
+        r.first = id;
+
+    // grow the array downwards or upwards, unless that would make it mostly
+    // empty:
+    int lo = std::min(r.first, id), hi = std::max<int>(r.first + r.widgets.size() - 1, id);
+    if(hi - lo >= std::max<int>(r.widgets.size(), 4 * (r.count + 1) + 64))
+    {
+        sparse[id] = widget;
+        return;
+    }
+    if(id < r.first)
+    {
+        r.widgets.insert(r.widgets.begin(), r.first - id, NULL);
+        r.first = id;
+    }
+    else if(id - r.first >= int(r.widgets.size()))
+    {
+        r.widgets.resize(id - r.first + 1, NULL);
+    }
+
+    Widget *&w = r.widgets[id - r.first];
+    if(!w) r.count++;
+    w = widget;
+    if(!sparse.empty())
+        sparse.erase(id);
+}
+
+void WidgetIndex::erase(int id)
+{
+    Range &r = range(id);
+    if(id >= r.first && id - r.first < int(r.widgets.size()) && r.widgets[id - r.first])
+    {
+        r.widgets[id - r.first] = NULL;
+        r.count--;
+    }
+    sparse.erase(id);
+}
+
+Widget * WidgetIndex::find(int id) const
+{
+    const Range &r = range(id);
+    if(id >= r.first && id - r.first < int(r.widgets.size()) && r.widgets[id - r.first])
+        return r.widgets[id - r.first];
+    if(sparse.empty())
+        return NULL;
+    auto it = sparse.find(id);
+    return it == sparse.end() ? NULL : it->second;
+}
+
 Proxy::Proxy(int sceneID_, int scriptID_, int scriptType_, Window *window_, std::map<int, Widget*>& widgets_)
-    : widgets(widgets_),
-      window(window_),
+    : window(window_),
       sceneID(sceneID_),
       scriptID(scriptID_),
-      scriptType(scriptType_)
+      scriptType(scriptType_),
+      async(window_->isAsync()),
+      batchDepth(0),
+      eventsDropped(false)
 {
     TRACE_FUNC;
+
+    // widgets whose creation is deferred (see LayoutWidget::createQtWidgetLazily)
+    // still need their proxy, for the commands issued in the meantime:
+    for(const auto &x : widgets_)
+        x.second->setProxy(this);
 }
 
 Proxy::~Proxy()
@@ -36,9 +97,33 @@ Proxy::~Proxy()
 
 Widget * Proxy::getWidgetById(int id)
 {
-    std::map<int, Widget*>::const_iterator it = widgets.find(id);
-    Widget *ret = it == widgets.end() ? NULL : it->second;
-    return ret;
+    return widgets.find(id);
+}
+
+void Proxy::addLazyWidget(Widget *widget)
+{
+    ASSERT_THREAD(UI);
+
+    lazyWidgets.push_back(widget->getRef());
+}
+
+void Proxy::materialize(Widget *widget)
+{
+    ASSERT_THREAD(UI);
+
+    // the widget's container is not known, so containers are created in
+    // order; a created container may defer the creation of nested ones,
+    // which are appended and visited by this same loop:
+    for(size_t i = 0; i < lazyWidgets.size() && !widget->getQWidget(); i++)
+    {
+        if(LayoutWidget *layoutWidget = dynamic_cast<LayoutWidget*>(Widget::byRef(lazyWidgets[i])))
+            layoutWidget->materialize();
+    }
+
+    lazyWidgets.erase(std::remove_if(lazyWidgets.begin(), lazyWidgets.end(), [](WidgetRef ref) {
+        LayoutWidget *layoutWidget = dynamic_cast<LayoutWidget*>(Widget::byRef(ref));
+        return !layoutWidget || layoutWidget->isMaterialized();
+    }), lazyWidgets.end());
 }
 
 void Proxy::createQtWidget(UI *ui)
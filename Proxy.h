@@ -3,15 +3,60 @@
 
 #include "config.h"
 
+#include <deque>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <QWidget>
 
+#include "CommandQueue.h"
+#include "stubs.h"
 #include "widgets/Window.h"
 
 class UI;
 
+/**
+ * the widgets of a UI, by id; ids are allocated densely (user defined ids
+ * are small positive integers, and automatically assigned ids are decreasing
+ * negative integers, see Widget::parse), so each range is stored in a flat
+ * array, indexed by the distance from its first id; ids too far apart to be
+ * stored that way go in a hash table instead
+ */
+class WidgetIndex
+{
+public:
+    void insert(int id, Widget *widget);
+    void erase(int id);
+    Widget * find(int id) const;
+
+    template<typename F>
+    void forEach(F f) const
+    {
+        for(const Range *r : {&positive, &negative})
+            for(Widget *widget : r->widgets)
+                if(widget) f(widget);
+        for(const auto &x : sparse)
+            f(x.second);
+    }
+
+private:
+    struct Range
+    {
+        Range() : first(0), count(0) {}
+        int first;
+        int count;
+        std::vector<Widget *> widgets; // [id - first] -> Widget
+    };
+
+    inline Range & range(int id) {return id >= 0 ? positive : negative;}
+    inline const Range & range(int id) const {return id >= 0 ? positive : negative;}
+
+    Range positive, negative;
+    std::unordered_map<int, Widget *> sparse;
+};
+
 class Proxy
 {
 public:
@@ -20,6 +65,14 @@ public:
 
     Widget * getWidgetById(int id);
 
+    // (UI thread) containers whose contents have not been created yet (see
+    // LayoutWidget::createQtWidgetLazily):
+    void addLazyWidget(Widget *widget);
+
+    // (UI thread) creates the contents of the containers until the given
+    // widget is created:
+    void materialize(Widget *widget);
+
     void createQtWidget(UI *ui);
 
     inline Window * getWidget() {return window;}
@@ -29,10 +82,14 @@ public:
     inline int getSceneID() {return sceneID;}
 
 private:
-    std::map<int, Widget *> widgets; // widgetId -> Widget
+    WidgetIndex widgets; // widgetId -> Widget
 
     std::string handle;
 
+    // the XML this has been created from, or last updated with (see
+    // simUI.update; accessed only from the SIM thread):
+    std::string xml;
+
     // UIModel's pointer:
     Window *window;
 
@@ -45,7 +102,28 @@ private:
     // the type of the scriptID above:
     int scriptType;
 
+    // if true, setters don't wait for the UI thread (see SIM::call):
+    bool async;
+
+    // function called when the Qt widgets have been created (see
+    // simUI.createAsync):
+    std::string onReady;
+
+    // commands recorded between simUI.beginBatch and simUI.commitBatch
+    // (accessed only from the SIM thread):
+    int batchDepth;
+    CommandBatch batch;
+
+    // events recorded for simUI.pollEvents, if the UI has poll-events="true"
+    // (accessed only from the SIM thread):
+    std::deque<event_info> events;
+    bool eventsDropped;
+
+    // see addLazyWidget:
+    std::vector<WidgetRef> lazyWidgets;
+
     friend class SIM;
+    friend class Stats;
     friend class UI;
     friend class Widget;
     friend class Plugin;
@@ -1,9 +1,14 @@
 #include "SIM.h"
+#include "Stats.h"
+#include "Trace.h"
 #include "UI.h"
 
 #include <QThread>
+#include <QTimer>
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 
 #include <simPlusPlus/Lib.h>
 #include "stubs.h"
@@ -13,7 +18,9 @@
 SIM *SIM::instance = NULL;
 
 SIM::SIM(QObject *parent)
-    : QObject(parent)
+    : QObject(parent),
+      lastBulk(4096),
+      lastUntrackedBulk(CommandIndex::npos)
 {
     connectSignals();
 }
@@ -65,76 +72,22 @@ void SIM::connectSignals()
     connect(ui, &UI::valueChangeInt, this, &SIM::onValueChangeInt);
     connect(ui, &UI::valueChangeDouble, this, &SIM::onValueChangeDouble);
     connect(ui, &UI::valueChangeString, this, &SIM::onValueChangeString);
+    connect(ui, &UI::mirrorChangeInt, this, &SIM::onMirrorChangeInt);
 #if WIDGET_EDIT
     connect(ui, &UI::editingFinished, this, &SIM::onEditingFinished);
 #endif
     connect(ui, &UI::windowClose, this, &SIM::onWindowClose);
+    connect(ui, &UI::windowReady, this, &SIM::onWindowReady);
+    connect(ui, &UI::windowStateChange, this, &SIM::onWindowStateChange);
     connect(this, &SIM::destroy, ui, &UI::onDestroy, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setStyleSheet, ui, &UI::onSetStyleSheet, Qt::BlockingQueuedConnection);
-#if WIDGET_BUTTON
-    connect(this, &SIM::setButtonText, ui, &UI::onSetButtonText, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setButtonPressed, ui, &UI::onSetButtonPressed, Qt::BlockingQueuedConnection);
-#endif
-    connect(this, &SIM::showWindow, ui, &UI::onShowWindow, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::hideWindow, ui, &UI::onHideWindow, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setPosition, ui, &UI::onSetPosition, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setSize, ui, &UI::onSetSize, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setTitle, ui, &UI::onSetTitle, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setWindowEnabled, ui, &UI::onSetWindowEnabled, Qt::BlockingQueuedConnection);
 #if WIDGET_IMAGE
-    connect(this, &SIM::setImage, ui, &UI::onSetImage, Qt::BlockingQueuedConnection);
     connect(ui, &UI::loadImageFromFile, this, &SIM::onLoadImageFromFile);
 #endif
     connect(this, &SIM::sceneChange, ui, &UI::onSceneChange, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setEnabled, ui, &UI::onSetEnabled, Qt::BlockingQueuedConnection);
-#if WIDGET_EDIT
-    connect(this, &SIM::setEditValue, ui, &UI::onSetEditValue, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_SPINBOX
-    connect(this, &SIM::setSpinboxValue, ui, &UI::onSetSpinboxValue, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_LABEL
-    connect(this, &SIM::setLabelText, ui, &UI::onSetLabelText, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_HSLIDER || WIDGET_VSLIDER
-    connect(this, &SIM::setSliderValue, ui, &UI::onSetSliderValue, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_CHECKBOX
-    connect(this, &SIM::setCheckboxValue, ui, &UI::onSetCheckboxValue, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_RADIOBUTTON
-    connect(this, &SIM::setRadiobuttonValue, ui, &UI::onSetRadiobuttonValue, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_COMBOBOX
-    connect(this, &SIM::insertComboboxItem, ui, &UI::onInsertComboboxItem, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::removeComboboxItem, ui, &UI::onRemoveComboboxItem, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setComboboxItems, ui, &UI::onSetComboboxItems, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setComboboxSelectedIndex, ui, &UI::onSetComboboxSelectedIndex, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TABS
-    connect(this, &SIM::setCurrentTab, ui, &UI::onSetCurrentTab, Qt::BlockingQueuedConnection);
-#endif
-    connect(this, &SIM::setWidgetVisibility, ui, &UI::onSetWidgetVisibility, Qt::BlockingQueuedConnection);
+    connect(this, &SIM::commandsPending, ui, &UI::onProcessCommands, Qt::QueuedConnection);
+    connect(this, &SIM::flushCommands, ui, &UI::onFlushCommands, Qt::BlockingQueuedConnection);
+    connect(this, &SIM::coalescedEventsPending, this, &SIM::onDeliverCoalescedEvents, Qt::QueuedConnection);
 #if WIDGET_PLOT
-    connect(this, &SIM::replot, ui, &UI::onReplot, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::addCurve, ui, &UI::onAddCurve, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::addCurveTimePoints, ui, &UI::onAddCurveTimePoints, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::addCurveXYPoints, ui, &UI::onAddCurveXYPoints, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::clearCurve, ui, &UI::onClearCurve, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::removeCurve, ui, &UI::onRemoveCurve, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setPlotRanges, ui, &UI::onSetPlotRanges, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setPlotXRange, ui, &UI::onSetPlotXRange, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setPlotYRange, ui, &UI::onSetPlotYRange, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::growPlotRanges, ui, &UI::onGrowPlotRanges, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::growPlotXRange, ui, &UI::onGrowPlotXRange, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::growPlotYRange, ui, &UI::onGrowPlotYRange, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setPlotLabels, ui, &UI::onSetPlotLabels, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setPlotXLabel, ui, &UI::onSetPlotXLabel, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setPlotYLabel, ui, &UI::onSetPlotYLabel, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::rescaleAxes, ui, &UI::onRescaleAxes, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::rescaleAxesAll, ui, &UI::onRescaleAxesAll, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setMouseOptions, ui, &UI::onSetMouseOptions, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setLegendVisibility, ui, &UI::onSetLegendVisibility, Qt::BlockingQueuedConnection);
     connect(ui, &UI::plottableClick, this, &SIM::onPlottableClick);
     connect(ui, &UI::legendClick, this, &SIM::onLegendClick);
 #endif
@@ -147,227 +100,646 @@ void SIM::connectSignals()
 #endif
 #if WIDGET_IMAGE
     connect(ui, &UI::mouseEvent, this, &SIM::onMouseEvent);
-#endif
-#if WIDGET_TABLE
-    connect(this, &SIM::clearTable, ui, &UI::onClearTable, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setRowCount, ui, &UI::onSetRowCount, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setColumnCountTable, ui, &UI::onSetColumnCountTable, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TREE
-    connect(this, &SIM::setColumnCountTree, ui, &UI::onSetColumnCountTree, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TABLE
-    connect(this, &SIM::setItem, ui, &UI::onSetItem, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setItemImage, ui, &UI::onSetItemImage, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setRowHeaderText, ui, &UI::onSetRowHeaderText, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setColumnHeaderTextTable, ui, &UI::onSetColumnHeaderTextTable, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TREE
-    connect(this, &SIM::setColumnHeaderTextTree, ui, &UI::onSetColumnHeaderTextTree, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TABLE
-    connect(this, &SIM::setItemEditable, ui, &UI::onSetItemEditable, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::restoreStateTable, ui, &UI::onRestoreStateTable, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TREE
-    connect(this, &SIM::restoreStateTree, ui, &UI::onRestoreStateTree, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TABLE
-    connect(this, &SIM::setRowHeight, ui, &UI::onSetRowHeight, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setColumnWidthTable, ui, &UI::onSetColumnWidthTable, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TREE
-    connect(this, &SIM::setColumnWidthTree, ui, &UI::onSetColumnWidthTree, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TABLE
-    connect(this, &SIM::setTableSelection, ui, &UI::onSetTableSelection, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_PROGRESSBAR
-    connect(this, &SIM::setProgress, ui, &UI::onSetProgress, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TREE
-    connect(this, &SIM::clearTree, ui, &UI::onClearTree, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::addTreeItem, ui, &UI::onAddTreeItem, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::updateTreeItemText, ui, &UI::onUpdateTreeItemText, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::updateTreeItemParent, ui, &UI::onUpdateTreeItemParent, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::removeTreeItem, ui, &UI::onRemoveTreeItem, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setTreeSelection, ui, &UI::onSetTreeSelection, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::expandAll, ui, &UI::onExpandAll, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::collapseAll, ui, &UI::onCollapseAll, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::expandToDepth, ui, &UI::onExpandToDepth, Qt::BlockingQueuedConnection);
-#endif
-#if WIDGET_TEXTBROWSER
-    connect(this, &SIM::setText, ui, &UI::onSetText, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setUrl, ui, &UI::onSetUrl, Qt::BlockingQueuedConnection);
 #endif
     connect(ui, &UI::keyPressed, this, &SIM::onKeyPress);
 #if WIDGET_SCENE3D
-    connect(this, &SIM::addScene3DNode, ui, &UI::onAddScene3DNode, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::removeScene3DNode, ui, &UI::onRemoveScene3DNode, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setScene3DNodeEnabled, ui, &UI::onSetScene3DNodeEnabled, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setScene3DIntParam, ui, &UI::onSetScene3DIntParam, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setScene3DFloatParam, ui, &UI::onSetScene3DFloatParam, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setScene3DStringParam, ui, &UI::onSetScene3DStringParam, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setScene3DVector2Param, ui, &UI::onSetScene3DVector2Param, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setScene3DVector3Param, ui, &UI::onSetScene3DVector3Param, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::setScene3DVector4Param, ui, &UI::onSetScene3DVector4Param, Qt::BlockingQueuedConnection);
     connect(ui, &UI::scene3DObjectClick, this, &SIM::onScene3DObjectClick);
 #endif
-#if WIDGET_SVG
-    connect(this, &SIM::svgLoadFile, ui, &UI::onSvgLoadFile, Qt::BlockingQueuedConnection);
-    connect(this, &SIM::svgLoadData, ui, &UI::onSvgLoadData, Qt::BlockingQueuedConnection);
-#endif
+}
+
+bool SIM::asyncByDefault()
+{
+    bool ret = false;
+    simInt len = 0;
+    simChar *s = simGetStringNamedParam("simUI.async", &len);
+    if(s)
+    {
+        std::string v(s, len);
+        ret = v == "true" || v == "1";
+        sim::releaseBuffer(s);
+    }
+    return ret;
+}
+
+void SIM::enqueue(Widget *widget, Property property, const char *name, CommandFunction f, bool deferrable, bool bulk)
+{
+    Command cmd{widget->getRef(), widget, property, name, bulk, std::move(f)};
+    cmd.mirrorSeq = widget->mirrorSeq;
+    enqueue(widget->proxy, std::move(cmd), deferrable);
+}
+
+void SIM::enqueue(Window *window, Property property, const char *name, CommandFunction f, bool deferrable, bool bulk)
+{
+    Command cmd{0, window, property, name, bulk, std::move(f)};
+    cmd.window = window->getRef();
+    enqueue(window->proxy, std::move(cmd), deferrable);
+}
+
+void SIM::enqueue(Proxy *proxy, Command &&cmd, bool deferrable)
+{
+    ASSERT_THREAD(!UI);
+
+    if(Stats::isEnabled())
+        cmd.enqueued = std::chrono::steady_clock::now();
+    const char *name = cmd.name;
+    Widget *widget = Widget::byRef(cmd.widget);
+
+    if(proxy && proxy->batchDepth > 0)
+    {
+        if(deferrable)
+        {
+            proxy->batch.push(std::move(cmd));
+            return;
+        }
+
+        // a synchronous command cannot wait for commitBatch(), so the
+        // commands recorded so far are sent before it, to preserve ordering
+        if(!proxy->batch.empty())
+            push(takeBatch(proxy));
+    }
+
+    CommandRing &ring = push(std::move(cmd));
+
+    if(deferrable && proxy && proxy->async)
+    {
+        // the UI thread will process this (and any following command) as soon
+        // as it gets back to its event loop; no need to notify it again if
+        // a notification is already pending
+        if(ring.requestWakeUp())
+        {
+            Trace::instant("emit", "commandsPending");
+            emit commandsPending();
+        }
+    }
+    else
+    {
+        // this also executes any async command enqueued before, so that
+        // commands are always executed in the order they have been issued
+        StatsTimer timer(Stats::SimBlocked, name, widget);
+        emit flushCommands();
+    }
+}
+
+CommandRing & SIM::push(Command &&cmd)
+{
+    UI *ui = UI::getInstance();
+
+    // a command cannot overtake the pending bulk commands of its target, nor
+    // a pending batch (which may contain commands for any target), so in
+    // that case it goes in the bulk lane too:
+    if(!cmd.bulk)
+    {
+        std::size_t pending = ui->bulkCommands.firstPending();
+        for(const void *target : {cmd.target, static_cast<const void *>(NULL)})
+        {
+            if(lastBulk.find(target, Property::None, pending) != CommandIndex::npos)
+                cmd.bulk = true;
+        }
+        if(!cmd.target && ui->bulkCommands.size() > 0)
+            cmd.bulk = true;
+        // (a bulk command which could not be recorded may be for any target)
+        if(lastUntrackedBulk != CommandIndex::npos && ui->bulkCommands.isPending(lastUntrackedBulk))
+            cmd.bulk = true;
+    }
+
+    CommandRing &ring = cmd.bulk ? ui->bulkCommands : ui->commands;
+
+    if(cmd.bulk)
+    {
+        // (the entries of the commands consumed already are reused)
+        bool recorded;
+        lastBulk.exchange(cmd.target, Property::None, ring.nextSequence(), ring.firstPending(), &recorded);
+        if(!recorded)
+            lastUntrackedBulk = ring.nextSequence();
+    }
+
+    // if the ring is full, wait for the UI thread to catch up:
+    while(!ring.push(cmd))
+    {
+        StatsTimer timer(Stats::SimBlocked, "(queue full)");
+        emit flushCommands();
+    }
+
+    return ring;
+}
+
+Command SIM::takeBatch(Proxy *proxy)
+{
+    std::deque<Command> cmds;
+    proxy->batch.take(cmds);
+    Command cmd{0, NULL, Property::None, "onApplyBatch", false, std::bind(&UI::onApplyBatch, UI::getInstance(), proxy->window->getRef(), std::move(cmds))};
+    if(Stats::isEnabled())
+        cmd.enqueued = std::chrono::steady_clock::now();
+    return cmd;
+}
+
+void SIM::createAsync(Proxy *proxy)
+{
+    ASSERT_THREAD(!UI);
+
+    // restored by onWindowReady():
+    proxy->async = true;
+
+    // the creation is a command like the others, so the commands issued in
+    // the meantime are executed after it, in order:
+    enqueue(proxy, Command{0, proxy->window, Property::None, "onCreateAsync", false, std::bind(&UI::onCreateAsync, UI::getInstance(), proxy)}, true);
+}
+
+void SIM::updateStructure(Proxy *proxy, Window *window, std::map<int, Widget*> &widgets, std::set<int> &unchanged)
+{
+    ASSERT_THREAD(!UI);
+
+    // not deferrable: the commands issued before are executed first, and
+    // the ones issued after see the new widgets:
+    enqueue(proxy, Command{0, proxy->window, Property::None, "onUpdateStructure", false, std::bind(&UI::onUpdateStructure, UI::getInstance(), proxy->window->getRef(), window, std::move(widgets), std::move(unchanged))}, false);
+}
+
+void SIM::beginBatch(Proxy *proxy)
+{
+    ASSERT_THREAD(!UI);
+
+    proxy->batchDepth++;
+}
+
+void SIM::commitBatch(Proxy *proxy)
+{
+    ASSERT_THREAD(!UI);
+
+    if(proxy->batchDepth <= 0)
+        throw std::runtime_error("commitBatch() called without beginBatch()");
+
+    // nested batches are committed together with the outermost one:
+    if(--proxy->batchDepth > 0) return;
+
+    if(proxy->batch.empty()) return;
+
+    enqueue(proxy, takeBatch(proxy), true);
+}
+
+/**
+ * with coalesce-events="true", high-frequency events (e.g. dragging a slider,
+ * or moving the mouse over an image) are not delivered immediately: only the
+ * latest event of each widget is kept, and delivered when the SIM thread
+ * processes its events again. any other event flushes the pending ones first,
+ * so that the order of events is preserved. returns false if the event must
+ * be delivered immediately, i.e. if the widget has coalesce-events="false"
+ * (the default)
+ */
+bool SIM::coalesceEvent(Widget *widget, CoalescedEventType type, CommandFunction deliver)
+{
+    if(!widget->coalesceEvents)
+    {
+        flushCoalescedEvents();
+        return false;
+    }
+
+    auto key = std::make_pair(widget->getRef(), type);
+    auto it = coalescedEventIndex.find(key);
+    if(it != coalescedEventIndex.end())
+    {
+        coalescedEvents[it->second].deliver = std::move(deliver);
+        return true;
+    }
+
+    if(coalescedEvents.empty())
+    {
+        Trace::instant("emit", "coalescedEventsPending");
+        emit coalescedEventsPending();
+    }
+    coalescedEventIndex[key] = coalescedEvents.size();
+    coalescedEvents.push_back(CoalescedEvent{widget->getRef(), type, std::move(deliver)});
+    return true;
+}
+
+void SIM::flushCoalescedEvents()
+{
+    // a callback may generate new events; those are delivered by the next flush
+    std::vector<CoalescedEvent> events;
+    events.swap(coalescedEvents);
+    coalescedEventIndex.clear();
+
+    for(auto &event : events)
+        event.deliver();
+}
+
+void SIM::onDeliverCoalescedEvents()
+{
+    ASSERT_THREAD(!UI);
+
+    flushCoalescedEvents();
+}
+
+static event_info newEvent(int id, const char *type)
+{
+    event_info event;
+    event.id = id;
+    event.type = type;
+    return event;
+}
+
+void SIM::queueEvent(Proxy *proxy, const event_info &event)
+{
+    // don't grow indefinitely if the script never polls the events:
+    if(proxy->events.size() >= 10000)
+    {
+        if(!proxy->eventsDropped)
+            sim::addLog(sim_verbosity_warnings, "too many events not polled for UI %s: discarding the oldest ones", proxy->handle);
+        proxy->eventsDropped = true;
+        proxy->events.pop_front();
+    }
+    proxy->events.push_back(event);
+}
+
+void SIM::takeEvents(Proxy *proxy, std::vector<event_info> &events)
+{
+    ASSERT_THREAD(!UI);
+
+    // the script should see also the most recent (coalesced) events:
+    flushCoalescedEvents();
+
+    events.assign(proxy->events.begin(), proxy->events.end());
+    proxy->events.clear();
+    proxy->eventsDropped = false;
+}
+
+/**
+ * limits the rate of the callbacks of a widget with the event-rate-limit (or
+ * event-min-interval-ms) attribute: the first event of a burst is delivered
+ * immediately (leading edge, unless event-rate-limit-edge="trailing"), and
+ * the latest of the events which arrive too early is delivered when the
+ * interval has elapsed (trailing edge), so that the final value is never lost.
+ * the state of a widget is discarded once its interval has elapsed with no
+ * new event. returns false if the event must be delivered now
+ */
+bool SIM::throttleEvent(Widget *widget, ThrottledEventType type, CommandFunction deliver)
+{
+    if(widget->eventMinInterval <= 0) return false;
+
+    ThrottledEventKey key(widget->getRef(), type);
+    auto it = throttledEvents.find(key);
+    if(it == throttledEvents.end())
+        it = throttledEvents.insert(std::make_pair(key, ThrottledEvent{std::chrono::steady_clock::time_point(), CommandFunction(), false, false})).first;
+    ThrottledEvent &t = it->second;
+
+    // this is the trailing edge delivery (see deliverThrottledEvent):
+    if(t.delivering) return false;
+
+    auto now = std::chrono::steady_clock::now();
+    std::chrono::milliseconds interval(widget->eventMinInterval);
+
+    if(!t.timerActive && widget->eventLeadingEdge && now - t.lastDelivery >= interval)
+    {
+        t.lastDelivery = now;
+        // the events of the next interval are held back:
+        startThrottleTimer(key, t, widget->eventMinInterval);
+        return false;
+    }
+
+    t.pending = std::move(deliver);
+
+    if(!t.timerActive)
+    {
+        auto due = widget->eventLeadingEdge ? t.lastDelivery + interval : now + interval;
+        startThrottleTimer(key, t, std::chrono::duration_cast<std::chrono::milliseconds>(due - now).count());
+    }
+
+    return true;
+}
+
+void SIM::startThrottleTimer(ThrottledEventKey key, ThrottledEvent &t, int ms)
+{
+    t.timerActive = true;
+    QTimer::singleShot(std::max(0, ms), this, [this, key] { deliverThrottledEvent(key); });
+}
+
+void SIM::deliverThrottledEvent(ThrottledEventKey key)
+{
+    ASSERT_THREAD(!UI);
+
+    auto it = throttledEvents.find(key);
+    if(it == throttledEvents.end()) return;
+
+    ThrottledEvent &t = it->second;
+    t.timerActive = false;
+
+    // (nothing arrived during the interval: the next event is a leading edge)
+    if(!t.pending || !Widget::byRef(key.first))
+    {
+        throttledEvents.erase(it);
+        return;
+    }
+
+    CommandFunction deliver(std::move(t.pending));
+    t.lastDelivery = std::chrono::steady_clock::now();
+    t.delivering = true;
+    deliver();
+
+    // the callback might have destroyed the UI:
+    it = throttledEvents.find(key);
+    if(it == throttledEvents.end()) return;
+    it->second.delivering = false;
+    Widget *widget = Widget::byRef(key.first);
+    if(widget && widget->eventLeadingEdge)
+        startThrottleTimer(key, it->second, widget->eventMinInterval);
+    else
+        throttledEvents.erase(it);
 }
 
 /**
  * while events are delivered, objects may be deleted in the other thread.
  * (this can happen when stopping the simulation for instance).
- * in order to prevent a crash, we check with Widget/Window::exists(..) if the
- * pointer refers to an object which is still valid (i.e. not deleted)
+ * in order to prevent a crash, windows and widgets are passed by reference
+ * (see WindowRef, WidgetRef), which resolves to NULL once the object has
+ * been deleted
  */
-#define CHECK_POINTER(clazz,p) \
-    if(!p) return; \
-    if(!clazz::exists(p)) {sim::addLog(sim_verbosity_warnings, "%s %x has already been deleted (or the pointer is invalid)", #clazz, p); return;} \
+#define CHECK_WINDOW(p,ref) \
+    if(!ref) return; \
+    Window *p = Window::byRef(ref); \
+    if(!p) {sim::addLog(sim_verbosity_warnings, "Window %x has already been deleted", ref); return;} \
+    if(!p->proxy) return;
+
+#define CHECK_WIDGET(clazz,p,ref) \
+    if(!ref) return; \
+    clazz *p = Widget::byRef<clazz>(ref); \
+    if(!p) {sim::addLog(sim_verbosity_warnings, "%s %x has already been deleted", #clazz, ref); return;} \
     if(!p->proxy) return;
 
 #if WIDGET_BUTTON
-void SIM::onButtonClick(Widget *widget)
+void SIM::onButtonClick(WidgetRef widgetRef)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, widget);
+    CHECK_WIDGET(Widget, widget, widgetRef);
+    flushCoalescedEvents();
 
-    EventOnClick *e = dynamic_cast<EventOnClick*>(widget);
+    if(widget->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(widget->id, "click");
+        queueEvent(widget->proxy, ev);
+        return;
+    }
 
-    if(!e) return;
-    if(e->onclick == "" || widget->proxy->scriptID == -1) return;
+    const std::string *onclick = widget->handlers.onclick;
+    if(!onclick) return;
 
     onclickCallback_in in;
     in.handle = widget->proxy->handle;
     in.id = widget->id;
     onclickCallback_out out;
-    onclickCallback(widget->proxy->scriptID, e->onclick.c_str(), &in, &out);
+    StatsTimer timer(Stats::Callback, "onclick", widget);
+    onclickCallback(widget->handlers.scriptID, onclick->c_str(), &in, &out);
 }
 #endif
 
 #if WIDGET_LABEL
-void SIM::onLinkActivated(Widget *widget, QString link)
+void SIM::onLinkActivated(WidgetRef widgetRef, QString link)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, widget);
+    CHECK_WIDGET(Widget, widget, widgetRef);
+    flushCoalescedEvents();
 
-    EventOnLinkActivated *e = dynamic_cast<EventOnLinkActivated*>(widget);
+    if(widget->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(widget->id, "link-activated");
+        ev.string_value = link.toStdString();
+        queueEvent(widget->proxy, ev);
+        return;
+    }
 
-    if(!e) return;
-    if(e->onLinkActivated == "" || widget->proxy->scriptID == -1) return;
+    const std::string *onLinkActivated = widget->handlers.onLinkActivated;
+    if(!onLinkActivated) return;
 
     onLinkActivatedCallback_in in;
     in.handle = widget->proxy->handle;
     in.id = widget->id;
     in.link = link.toStdString();
     onLinkActivatedCallback_out out;
-    onLinkActivatedCallback(widget->proxy->scriptID, e->onLinkActivated.c_str(), &in, &out);
+    StatsTimer timer(Stats::Callback, "onLinkActivated", widget);
+    onLinkActivatedCallback(widget->handlers.scriptID, onLinkActivated->c_str(), &in, &out);
 }
 #endif
 
-void SIM::onValueChangeInt(Widget *widget, int value)
+void SIM::onValueChangeInt(WidgetRef widgetRef, int value, quint32 mirrorSeq)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, widget);
-
-    EventOnChangeInt *ei = dynamic_cast<EventOnChangeInt*>(widget);
-    EventOnChangeDouble *ed = 0L;
-#if WIDGET_SPINBOX
-    /* XXX: spinbox inherits EventOnChangeDouble; however, when float="false",
-     *      it emits a valueChanged(int) signal. So we try to read here also
-     *      for a EventOnChangeDouble handler here to cover for that case.
-     */
-    ed = dynamic_cast<Spinbox*>(widget) ? dynamic_cast<EventOnChangeDouble*>(widget) : 0;
-#endif
+    CHECK_WIDGET(Widget, widget, widgetRef);
+
+    // keep the mirrored state (used by getters) in sync with the Qt widget,
+    // unless a setter has been called since (the event is still delivered):
+    if(mirrorSeq == widget->mirrorSeq)
+        widget->mirrorValueChange(value);
+
+    if(coalesceEvent(widget, CoalescedEventType::ValueChange, std::bind(&SIM::valueChangeInt, this, widgetRef, value)))
+        return;
+    valueChangeInt(widgetRef, value);
+}
+
+void SIM::valueChangeInt(WidgetRef widgetRef, int value)
+{
+    CHECK_WIDGET(Widget, widget, widgetRef);
+
+    const std::string *onchange = widget->handlers.onchange;
+    // (with poll-events the event is recorded even if there is no callback)
+    if(!onchange && !widget->proxy->window->pollEvents) return;
 
-    if(!ei && !ed) return;
-    std::string onchange = ei ? ei->onchange : ed->onchange;
-    if(onchange == "" || widget->proxy->scriptID == -1) return;
+    if(throttleEvent(widget, ThrottledEventType::Change, std::bind(&SIM::valueChangeInt, this, widgetRef, value)))
+        return;
+
+    if(widget->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(widget->id, "change");
+        ev.int_value = value;
+        queueEvent(widget->proxy, ev);
+        return;
+    }
 
     onchangeIntCallback_in in;
     in.handle = widget->proxy->handle;
     in.id = widget->id;
     in.value = value;
     onchangeIntCallback_out out;
-    onchangeIntCallback(widget->proxy->scriptID, onchange.c_str(), &in, &out);
+    StatsTimer timer(Stats::Callback, "onchangeInt", widget);
+    onchangeIntCallback(widget->handlers.scriptID, onchange->c_str(), &in, &out);
+}
+
+void SIM::onMirrorChangeInt(WidgetRef widgetRef, int value, quint32 mirrorSeq)
+{
+    ASSERT_THREAD(!UI);
+    CHECK_WIDGET(Widget, widget, widgetRef);
+
+    // only the mirrored state is updated: no event is delivered
+    if(mirrorSeq == widget->mirrorSeq)
+        widget->mirrorValueChange(value);
 }
 
-void SIM::onValueChangeDouble(Widget *widget, double value)
+void SIM::onValueChangeDouble(WidgetRef widgetRef, double value, quint32 mirrorSeq)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, widget);
+    CHECK_WIDGET(Widget, widget, widgetRef);
 
-    EventOnChangeDouble *e = dynamic_cast<EventOnChangeDouble*>(widget);
+    if(mirrorSeq == widget->mirrorSeq)
+        widget->mirrorValueChange(value);
 
-    if(!e) return;
-    if(e->onchange == "" || widget->proxy->scriptID == -1) return;
+    if(coalesceEvent(widget, CoalescedEventType::ValueChange, std::bind(&SIM::valueChangeDouble, this, widgetRef, value)))
+        return;
+    valueChangeDouble(widgetRef, value);
+}
+
+void SIM::valueChangeDouble(WidgetRef widgetRef, double value)
+{
+    CHECK_WIDGET(Widget, widget, widgetRef);
+
+    const std::string *onchange = widget->handlers.onchange;
+    // (with poll-events the event is recorded even if there is no callback)
+    if(!onchange && !widget->proxy->window->pollEvents) return;
+
+    if(throttleEvent(widget, ThrottledEventType::Change, std::bind(&SIM::valueChangeDouble, this, widgetRef, value)))
+        return;
+
+    if(widget->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(widget->id, "change");
+        ev.float_value = value;
+        queueEvent(widget->proxy, ev);
+        return;
+    }
 
     onchangeDoubleCallback_in in;
     in.handle = widget->proxy->handle;
     in.id = widget->id;
     in.value = value;
     onchangeDoubleCallback_out out;
-    onchangeDoubleCallback(widget->proxy->scriptID, e->onchange.c_str(), &in, &out);
+    StatsTimer timer(Stats::Callback, "onchangeDouble", widget);
+    onchangeDoubleCallback(widget->handlers.scriptID, onchange->c_str(), &in, &out);
 }
 
-void SIM::onValueChangeString(Widget *widget, QString value)
+void SIM::onValueChangeString(WidgetRef widgetRef, QString value, quint32 mirrorSeq)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, widget);
+    CHECK_WIDGET(Widget, widget, widgetRef);
 
-    EventOnChangeString *e = dynamic_cast<EventOnChangeString*>(widget);
+    if(mirrorSeq == widget->mirrorSeq)
+        widget->mirrorValueChange(value.toStdString());
 
-    if(!e) return;
-    if(e->onchange == "" || widget->proxy->scriptID == -1) return;
+    if(coalesceEvent(widget, CoalescedEventType::ValueChange, std::bind(&SIM::valueChangeString, this, widgetRef, value)))
+        return;
+    valueChangeString(widgetRef, value);
+}
+
+void SIM::valueChangeString(WidgetRef widgetRef, QString value)
+{
+    CHECK_WIDGET(Widget, widget, widgetRef);
+
+    const std::string *onchange = widget->handlers.onchange;
+    // (with poll-events the event is recorded even if there is no callback)
+    if(!onchange && !widget->proxy->window->pollEvents) return;
+
+    if(throttleEvent(widget, ThrottledEventType::Change, std::bind(&SIM::valueChangeString, this, widgetRef, value)))
+        return;
+
+    if(widget->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(widget->id, "change");
+        ev.string_value = value.toStdString();
+        queueEvent(widget->proxy, ev);
+        return;
+    }
 
     onchangeStringCallback_in in;
     in.handle = widget->proxy->handle;
     in.id = widget->id;
     in.value = value.toStdString();
     onchangeStringCallback_out out;
-    onchangeStringCallback(widget->proxy->scriptID, e->onchange.c_str(), &in, &out);
+    StatsTimer timer(Stats::Callback, "onchangeString", widget);
+    onchangeStringCallback(widget->handlers.scriptID, onchange->c_str(), &in, &out);
 }
 
 #if WIDGET_EDIT
-void SIM::onEditingFinished(Edit *edit, QString value)
+void SIM::onEditingFinished(WidgetRef editRef, QString value)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, edit);
+    CHECK_WIDGET(Edit, edit, editRef);
+    flushCoalescedEvents();
 
-    EventOnEditingFinished *e = dynamic_cast<EventOnEditingFinished*>(edit);
+    if(edit->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(edit->id, "editing-finished");
+        ev.string_value = value.toStdString();
+        queueEvent(edit->proxy, ev);
+        return;
+    }
 
-    if(!e) return;
-    if(e->oneditingfinished == "" || edit->proxy->scriptID == -1) return;
+    const std::string *oneditingfinished = edit->handlers.oneditingfinished;
+    if(!oneditingfinished) return;
 
     oneditingfinishedCallback_in in;
     in.handle = edit->proxy->handle;
     in.id = edit->id;
     in.value = value.toStdString();
     oneditingfinishedCallback_out out;
-    oneditingfinishedCallback(edit->proxy->scriptID, e->oneditingfinished.c_str(), &in, &out);
+    StatsTimer timer(Stats::Callback, "oneditingfinished", edit);
+    oneditingfinishedCallback(edit->handlers.scriptID, oneditingfinished->c_str(), &in, &out);
 }
 #endif
 
-void SIM::onWindowClose(Window *window)
+void SIM::onWindowClose(WindowRef windowRef)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Window, window);
+    CHECK_WINDOW(window, windowRef);
+    flushCoalescedEvents();
+
+    if(window->pollEvents)
+    {
+        event_info ev = newEvent(0, "close");
+        queueEvent(window->proxy, ev);
+        return;
+    }
 
     oncloseCallback_in in;
     in.handle = window->proxy->handle;
     oncloseCallback_out out;
+    StatsTimer timer(Stats::Callback, "onclose");
     oncloseCallback(window->proxy->getScriptID(), window->onclose.c_str(), &in, &out);
 }
 
+void SIM::onWindowReady(WindowRef windowRef)
+{
+    ASSERT_THREAD(!UI);
+    CHECK_WINDOW(window, windowRef);
+
+    Proxy *proxy = window->proxy;
+    proxy->async = window->isAsync();
+
+    if(window->pollEvents)
+    {
+        event_info ev = newEvent(0, "ready");
+        queueEvent(proxy, ev);
+        return;
+    }
+
+    if(proxy->onReady == "" || proxy->scriptID == -1) return;
+
+    onReadyCallback_in in;
+    in.handle = proxy->handle;
+    onReadyCallback_out out;
+    StatsTimer timer(Stats::Callback, "onReady");
+    onReadyCallback(proxy->getScriptID(), proxy->onReady.c_str(), &in, &out);
+}
+
+void SIM::onWindowStateChange(WindowRef windowRef, bool visible, int x, int y, int w, int h)
+{
+    ASSERT_THREAD(!UI);
+    CHECK_WINDOW(window, windowRef);
+
+    window->mirror_visible = visible;
+    window->mirror_pos = QPoint(x, y);
+    window->mirror_size = QSize(w, h);
+}
+
 #if WIDGET_IMAGE
-void SIM::onLoadImageFromFile(Image *image, const char *filename, int w, int h)
+void SIM::onLoadImageFromFile(WidgetRef imageRef, const char *filename, int w, int h)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, image);
+    CHECK_WIDGET(Image, image, imageRef);
 
     int resolution[2];
     simUChar *data = simLoadImage(resolution, 0, filename, NULL);
@@ -378,20 +750,32 @@ void SIM::onLoadImageFromFile(Image *image, const char *filename, int w, int h)
         int size[2] = {w, h};
         simUChar *scaled = simGetScaledImage(data, resolution, size, 0, NULL);
         sim::releaseBuffer((simChar *)data);
-        setImage(image, (simChar *)scaled, w, h);
+        updateBulk(image, Property::Image, UI_SLOT(onSetImage), makeImageData((simChar *)scaled), w, h);
     }
     else
     {
-        setImage(image, (simChar *)data, resolution[0], resolution[1]);
+        updateBulk(image, Property::Image, UI_SLOT(onSetImage), makeImageData((simChar *)data), resolution[0], resolution[1]);
     }
 }
 #endif
 
 #if WIDGET_PLOT
-void SIM::onPlottableClick(Plot *plot, std::string name, int index, double x, double y)
+void SIM::onPlottableClick(WidgetRef plotRef, std::string name, int index, double x, double y)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, plot);
+    CHECK_WIDGET(Plot, plot, plotRef);
+    flushCoalescedEvents();
+
+    if(plot->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(plot->id, "plottable-click");
+        ev.string_value = name;
+        ev.int_value = index;
+        ev.x = x;
+        ev.y = y;
+        queueEvent(plot->proxy, ev);
+        return;
+    }
 
     if(plot->onCurveClick == "" || plot->proxy->scriptID == -1) return;
 
@@ -403,13 +787,23 @@ void SIM::onPlottableClick(Plot *plot, std::string name, int index, double x, do
     in.x = x;
     in.y = y;
     onPlottableClickCallback_out out;
+    StatsTimer timer(Stats::Callback, "onPlottableClick", plot);
     onPlottableClickCallback(plot->proxy->getScriptID(), plot->onCurveClick.c_str(), &in, &out);
 }
 
-void SIM::onLegendClick(Plot *plot, std::string name)
+void SIM::onLegendClick(WidgetRef plotRef, std::string name)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, plot);
+    CHECK_WIDGET(Plot, plot, plotRef);
+    flushCoalescedEvents();
+
+    if(plot->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(plot->id, "legend-click");
+        ev.string_value = name;
+        queueEvent(plot->proxy, ev);
+        return;
+    }
 
     if(plot->onLegendClick == "" || plot->proxy->scriptID == -1) return;
 
@@ -418,15 +812,27 @@ void SIM::onLegendClick(Plot *plot, std::string name)
     in.id = plot->id;
     in.curve = name;
     onLegendClickCallback_out out;
+    StatsTimer timer(Stats::Callback, "onLegendClick", plot);
     onLegendClickCallback(plot->proxy->getScriptID(), plot->onLegendClick.c_str(), &in, &out);
 }
 #endif
 
 #if WIDGET_TABLE
-void SIM::onCellActivate(Table *table, int row, int col, std::string text)
+void SIM::onCellActivate(WidgetRef tableRef, int row, int col, std::string text)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, table);
+    CHECK_WIDGET(Table, table, tableRef);
+    flushCoalescedEvents();
+
+    if(table->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(table->id, "cell-activate");
+        ev.row = row;
+        ev.column = col;
+        ev.string_value = text;
+        queueEvent(table->proxy, ev);
+        return;
+    }
 
     if(table->onCellActivate == "" || table->proxy->scriptID == -1) return;
 
@@ -437,13 +843,24 @@ void SIM::onCellActivate(Table *table, int row, int col, std::string text)
     in.column = col;
     in.cellValue = text;
     onCellActivateCallback_out out;
+    StatsTimer timer(Stats::Callback, "onCellActivate", table);
     onCellActivateCallback(table->proxy->getScriptID(), table->onCellActivate.c_str(), &in, &out);
 }
 
-void SIM::onSelectionChangeTable(Table *table, int row, int col)
+void SIM::onSelectionChangeTable(WidgetRef tableRef, int row, int col)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, table);
+    CHECK_WIDGET(Table, table, tableRef);
+    flushCoalescedEvents();
+
+    if(table->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(table->id, "selection-change");
+        ev.row = row;
+        ev.column = col;
+        queueEvent(table->proxy, ev);
+        return;
+    }
 
     if(table->onSelectionChange == "" || table->proxy->scriptID == -1) return;
 
@@ -453,15 +870,25 @@ void SIM::onSelectionChangeTable(Table *table, int row, int col)
     in.row = row;
     in.column = col;
     onTableSelectionChangeCallback_out out;
+    StatsTimer timer(Stats::Callback, "onTableSelectionChange", table);
     onTableSelectionChangeCallback(table->proxy->getScriptID(), table->onSelectionChange.c_str(), &in, &out);
 }
 #endif
 
 #if WIDGET_TREE
-void SIM::onSelectionChangeTree(Tree *tree, int id)
+void SIM::onSelectionChangeTree(WidgetRef treeRef, int id)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, tree);
+    CHECK_WIDGET(Tree, tree, treeRef);
+    flushCoalescedEvents();
+
+    if(tree->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(tree->id, "selection-change");
+        ev.int_value = id;
+        queueEvent(tree->proxy, ev);
+        return;
+    }
 
     if(tree->onSelectionChange == "" || tree->proxy->scriptID == -1) return;
 
@@ -470,58 +897,93 @@ void SIM::onSelectionChangeTree(Tree *tree, int id)
     in.id = tree->id;
     in.item_id = id;
     onTreeSelectionChangeCallback_out out;
+    StatsTimer timer(Stats::Callback, "onTreeSelectionChange", tree);
     onTreeSelectionChangeCallback(tree->proxy->getScriptID(), tree->onSelectionChange.c_str(), &in, &out);
 }
 #endif
 
 #if WIDGET_IMAGE || WIDGET_SVG
-void SIM::onMouseEvent(Widget *widget, int type, bool shift, bool control, int x, int y)
+void SIM::onMouseEvent(WidgetRef widgetRef, int type, bool shift, bool control, int x, int y)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, widget);
+    CHECK_WIDGET(Widget, widget, widgetRef);
 
-    if(widget->proxy->scriptID == -1) return;
+    if(type == sim_ui_mouse_move)
+    {
+        if(coalesceEvent(widget, CoalescedEventType::MouseMove, std::bind(&SIM::mouseEvent, this, widgetRef, type, shift, control, x, y)))
+            return;
+    }
+    else
+    {
+        flushCoalescedEvents();
+    }
+    mouseEvent(widgetRef, type, shift, control, x, y);
+}
 
-    onMouseEventCallback_in in;
-    in.handle = widget->proxy->handle;
-    in.id = widget->id;
-    in.type = type;
-    in.mods.shift = shift;
-    in.mods.control = control;
-    in.x = x;
-    in.y = y;
-    onMouseEventCallback_out out;
-    std::string cb = "";
+void SIM::mouseEvent(WidgetRef widgetRef, int type, bool shift, bool control, int x, int y)
+{
+    CHECK_WIDGET(Widget, widget, widgetRef);
+
+    const std::string *cb = NULL;
     switch(type)
     {
     case sim_ui_mouse_left_button_down:
-        if(auto *eDown = dynamic_cast<EventOnMouseDown*>(widget))
-            cb = eDown->onMouseDown;
+        cb = widget->handlers.onMouseDown;
         break;
     case sim_ui_mouse_left_button_up:
-        if(auto *eUp = dynamic_cast<EventOnMouseUp*>(widget))
-            cb = eUp->onMouseUp;
+        cb = widget->handlers.onMouseUp;
         break;
     case sim_ui_mouse_move:
-        if(auto *eMove = dynamic_cast<EventOnMouseMove*>(widget))
-            cb = eMove->onMouseMove;
+        cb = widget->handlers.onMouseMove;
         break;
     }
-    if(cb == "") return;
-    onMouseEventCallback(widget->proxy->getScriptID(), cb.c_str(), &in, &out);
+    // (with poll-events the event is recorded even if there is no callback)
+    if(!cb && !widget->proxy->window->pollEvents) return;
+    if(type == sim_ui_mouse_move && throttleEvent(widget, ThrottledEventType::MouseMove, std::bind(&SIM::mouseEvent, this, widgetRef, type, shift, control, x, y)))
+        return;
+    if(widget->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(widget->id, "mouse");
+        ev.int_value = type;
+        ev.shift = shift;
+        ev.control = control;
+        ev.x = x;
+        ev.y = y;
+        queueEvent(widget->proxy, ev);
+        return;
+    }
+
+    onMouseEventCallback_in in;
+    in.handle = widget->proxy->handle;
+    in.id = widget->id;
+    in.type = type;
+    in.mods.shift = shift;
+    in.mods.control = control;
+    in.x = x;
+    in.y = y;
+    onMouseEventCallback_out out;
+    StatsTimer timer(Stats::Callback, "onMouseEvent", widget);
+    onMouseEventCallback(widget->handlers.scriptID, cb->c_str(), &in, &out);
 }
 #endif
 
-void SIM::onKeyPress(Widget *widget, int key, std::string text)
+void SIM::onKeyPress(WidgetRef widgetRef, int key, std::string text)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, widget);
+    CHECK_WIDGET(Widget, widget, widgetRef);
+    flushCoalescedEvents();
 
-    if(widget->proxy->scriptID == -1) return;
+    if(widget->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(widget->id, "key-press");
+        ev.int_value = key;
+        ev.string_value = text;
+        queueEvent(widget->proxy, ev);
+        return;
+    }
 
-    EventOnKeyPress *e = dynamic_cast<EventOnKeyPress*>(widget);
-    if(!e) return;
-    if(e->onKeyPress == "") return;
+    const std::string *onKeyPress = widget->handlers.onKeyPress;
+    if(!onKeyPress) return;
 
     onKeyPressCallback_in in;
     in.handle = widget->proxy->handle;
@@ -529,14 +991,24 @@ void SIM::onKeyPress(Widget *widget, int key, std::string text)
     in.key = key;
     in.text = text;
     onKeyPressCallback_out out;
-    onKeyPressCallback(widget->proxy->getScriptID(), e->onKeyPress.c_str(), &in, &out);
+    StatsTimer timer(Stats::Callback, "onKeyPress", widget);
+    onKeyPressCallback(widget->handlers.scriptID, onKeyPress->c_str(), &in, &out);
 }
 
 #if WIDGET_SCENE3D
-void SIM::onScene3DObjectClick(Scene3D *scene3d, int id)
+void SIM::onScene3DObjectClick(WidgetRef scene3dRef, int id)
 {
     ASSERT_THREAD(!UI);
-    CHECK_POINTER(Widget, scene3d);
+    CHECK_WIDGET(Scene3D, scene3d, scene3dRef);
+    flushCoalescedEvents();
+
+    if(scene3d->proxy->window->pollEvents)
+    {
+        event_info ev = newEvent(scene3d->id, "object-click");
+        ev.int_value = id;
+        queueEvent(scene3d->proxy, ev);
+        return;
+    }
 
     if(scene3d->proxy->scriptID == -1) return;
 
@@ -547,6 +1019,7 @@ void SIM::onScene3DObjectClick(Scene3D *scene3d, int id)
     in.id = scene3d->id;
     in.nodeId = id;
     onScene3DObjectClickCallback_out out;
+    StatsTimer timer(Stats::Callback, "onScene3DObjectClick", scene3d);
     onScene3DObjectClickCallback(scene3d->proxy->getScriptID(), scene3d->onClick.c_str(), &in, &out);
 }
 #endif
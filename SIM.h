@@ -3,13 +3,23 @@
 
 #include "config.h"
 
+#include <chrono>
+#include <functional>
+#include <map>
+#include <set>
+#include <vector>
+
 #include <QObject>
 #include <QString>
 
 #include "Proxy.h"
+#include "UI.h"
 #include "stubs.h"
 #include "widgets/all.h"
 
+// a UI slot and its name, as passed to SIM::call, SIM::update and SIM::callSync
+#define UI_SLOT(slot) &UI::slot, #slot
+
 class SIM : public QObject
 {
     Q_OBJECT
@@ -30,50 +40,55 @@ private:
 public slots:
 
 private slots:
+    void onDeliverCoalescedEvents();
+
 #if WIDGET_BUTTON
-    void onButtonClick(Widget *widget);
+    void onButtonClick(WidgetRef widgetRef);
 #endif
 
 #if WIDGET_LABEL
-    void onLinkActivated(Widget *widget, QString link);
+    void onLinkActivated(WidgetRef widgetRef, QString link);
 #endif
 
-    void onValueChangeInt(Widget *widget, int value);
-    void onValueChangeDouble(Widget *widget, double value);
-    void onValueChangeString(Widget *widget, QString value);
+    void onValueChangeInt(WidgetRef widgetRef, int value, quint32 mirrorSeq);
+    void onValueChangeDouble(WidgetRef widgetRef, double value, quint32 mirrorSeq);
+    void onValueChangeString(WidgetRef widgetRef, QString value, quint32 mirrorSeq);
+    void onMirrorChangeInt(WidgetRef widgetRef, int value, quint32 mirrorSeq);
 
 #if WIDGET_EDIT
-    void onEditingFinished(Edit *edit, QString value);
+    void onEditingFinished(WidgetRef editRef, QString value);
 #endif
 
-    void onWindowClose(Window *window);
+    void onWindowClose(WindowRef windowRef);
+    void onWindowReady(WindowRef windowRef);
+    void onWindowStateChange(WindowRef windowRef, bool visible, int x, int y, int w, int h);
 
 #if WIDGET_IMAGE
-    void onLoadImageFromFile(Image *image, const char *filename, int w, int h);
+    void onLoadImageFromFile(WidgetRef imageRef, const char *filename, int w, int h);
 #endif
 
 #if WIDGET_PLOT
-    void onPlottableClick(Plot *plot, std::string name, int index, double x, double y);
-    void onLegendClick(Plot *plot, std::string name);
+    void onPlottableClick(WidgetRef plotRef, std::string name, int index, double x, double y);
+    void onLegendClick(WidgetRef plotRef, std::string name);
 #endif
 
 #if WIDGET_TABLE
-    void onCellActivate(Table *table, int row, int col, std::string text);
-    void onSelectionChangeTable(Table *table, int row, int col);
+    void onCellActivate(WidgetRef tableRef, int row, int col, std::string text);
+    void onSelectionChangeTable(WidgetRef tableRef, int row, int col);
 #endif
 
 #if WIDGET_TREE
-    void onSelectionChangeTree(Tree *tree, int id);
+    void onSelectionChangeTree(WidgetRef treeRef, int id);
 #endif
 
 #if WIDGET_IMAGE
-    void onMouseEvent(Widget *widget, int type, bool shift, bool control, int x, int y);
+    void onMouseEvent(WidgetRef widgetRef, int type, bool shift, bool control, int x, int y);
 #endif
 
-    void onKeyPress(Widget *widget, int key, std::string text);
+    void onKeyPress(WidgetRef widgetRef, int key, std::string text);
 
 #if WIDGET_SCENE3D
-    void onScene3DObjectClick(Scene3D *scene3d, int id);
+    void onScene3DObjectClick(WidgetRef scene3dRef, int id);
 #endif
 
 signals:
@@ -82,140 +97,170 @@ signals:
     void colorDialog(std::vector<float> initColor, std::string title, bool showAlphaChannel, bool native, std::vector<float> *result);
     void create(Proxy *proxy);
     void destroy(Proxy *proxy);
-    void setStyleSheet(Widget *widget, std::string styleSheet);
-    void showWindow(Window *window);
-    void hideWindow(Window *window);
-    void setPosition(Window *window, int x, int y);
-    void setSize(Window *window, int w, int h);
-    void setTitle(Window *window, std::string title);
-    void setWindowEnabled(Window *window, bool enabled);
-
-#if WIDGET_IMAGE
-    void setImage(Image *image, const char *data, int w, int h);
-#endif
-
     void sceneChange(Window *window, int oldSceneID, int newSceneID);
-    void setEnabled(Widget *widget, bool enabled);
-
-#if WIDGET_BUTTON
-    void setButtonText(Button *button, std::string text);
-    void setButtonPressed(Button *button, bool pressed);
-#endif
-
-#if WIDGET_EDIT
-    void setEditValue(Edit *edit, std::string value, bool suppressSignals);
-#endif
 
-#if WIDGET_SPINBOX
-    void setSpinboxValue(Spinbox *spinbox, double value, bool suppressSignals);
-#endif
+    // wake up the UI thread to process the command queue (non-blocking):
+    void commandsPending();
 
-#if WIDGET_LABEL
-    void setLabelText(Label *label, std::string text, bool suppressSignals);
-#endif
+    // process the command queue and wait until it is done (blocking):
+    void flushCommands();
 
-#if WIDGET_HSLIDER || WIDGET_VSLIDER
-    void setSliderValue(Slider *slider, int value, bool suppressSignals);
-#endif
+    // deliver the coalesced events later (see SIM::coalesceEvent):
+    void coalescedEventsPending();
 
-#if WIDGET_CHECKBOX
-    void setCheckboxValue(Checkbox *checkbox, Qt::CheckState value, bool suppressSignals);
-#endif
-
-#if WIDGET_RADIOBUTTON
-    void setRadiobuttonValue(Radiobutton *radiobutton, bool value, bool suppressSignals);
-#endif
-
-#if WIDGET_COMBOBOX
-    void insertComboboxItem(Combobox *combobox, int index, std::string text, bool suppressSignals);
-    void removeComboboxItem(Combobox *combobox, int index, bool suppressSignals);
-    void setComboboxItems(Combobox *combobox, std::vector<std::string> items, int index, bool suppressEvents);
-    void setComboboxSelectedIndex(Combobox *combobox, int index, bool suppressEvents);
-#endif
-
-#if WIDGET_TABS
-    void setCurrentTab(Tabs *tabs, int index, bool suppressSignals);
-#endif
-
-    void setWidgetVisibility(Widget *widget, bool visible);
-
-#if WIDGET_PLOT
-    void replot(Plot *plot);
-    void addCurve(Plot *plot, int type, std::string name, std::vector<int> color, int style, curve_options *opts);
-    void addCurveTimePoints(Plot *plot, std::string name, std::vector<double> x, std::vector<double> y);
-    void addCurveXYPoints(Plot *plot, std::string name, std::vector<double> t, std::vector<double> x, std::vector<double> y);
-    void clearCurve(Plot *plot, std::string name);
-    void removeCurve(Plot *plot, std::string name);
-    void setPlotRanges(Plot *plot, double xmin, double xmax, double ymin, double ymax);
-    void setPlotXRange(Plot *plot, double xmin, double xmax);
-    void setPlotYRange(Plot *plot, double ymin, double ymax);
-    void growPlotRanges(Plot *plot, double xmin, double xmax, double ymin, double ymax);
-    void growPlotXRange(Plot *plot, double xmin, double xmax);
-    void growPlotYRange(Plot *plot, double ymin, double ymax);
-    void setPlotLabels(Plot *plot, std::string x, std::string y);
-    void setPlotXLabel(Plot *plot, std::string label);
-    void setPlotYLabel(Plot *plot, std::string label);
-    void rescaleAxes(Plot *plot, std::string name, bool onlyEnlargeX, bool onlyEnlargeY);
-    void rescaleAxesAll(Plot *plot, bool onlyEnlargeX, bool onlyEnlargeY);
-    void setMouseOptions(Plot *plot, bool panX, bool panY, bool zoomX, bool zoomY);
-    void setLegendVisibility(Plot *plot, bool visible);
-#endif
-
-#if WIDGET_TABLE
-    void clearTable(Table *table, bool suppressSignals);
-    void setRowCount(Table *table, int count, bool suppressSignals);
-    void setColumnCountTable(Table *table, int count, bool suppressSignals);
-    void setItem(Table *table, int row, int col, std::string text, bool suppressSignals);
-    void setItemImage(Table *table, int row, int col, std::string data, int width, int height, bool suppressSignals);
-    void setRowHeaderText(Table *table, int row, std::string text);
-    void setColumnHeaderTextTable(Table *table, int col, std::string text);
-    void setItemEditable(Table *table, int row, int col, bool editable);
-    void restoreStateTable(Table *table, std::string state);
-    void setRowHeight(Table *table, int row, int min_size, int max_size);
-    void setColumnWidthTable(Table *table, int column, int min_size, int max_size);
-    void setTableSelection(Table *table, int row, int col, bool suppressSignals);
-#endif
-
-#if WIDGET_PROGRESSBAR
-    void setProgress(Progressbar *progressbar, int value);
-#endif
-
-#if WIDGET_TREE
-    void setColumnCountTree(Tree *tree, int count, bool suppressSignals);
-    void setColumnHeaderTextTree(Tree *tree, int col, std::string text);
-    void restoreStateTree(Tree *tree, std::string state);
-    void setColumnWidthTree(Tree *tree, int column, int min_size, int max_size);
-    void clearTree(Tree *tree, bool suppressSignals);
-    void addTreeItem(Tree *tree, int item_id, int parent_id, std::vector<std::string> text, bool expanded, bool suppressEvents);
-    void updateTreeItemText(Tree *tree, int item_id, std::vector<std::string> text);
-    void updateTreeItemParent(Tree *tree, int item_id, int parent_id, bool suppressSignals);
-    void removeTreeItem(Tree *tree, int item_id, bool suppressEvents);
-    void setTreeSelection(Tree *tree, int item_id, bool suppressSignals);
-    void expandAll(Tree *tree, bool suppressSignals);
-    void collapseAll(Tree *tree, bool suppressSignals);
-    void expandToDepth(Tree *tree, int depth, bool suppressSignals);
-#endif
-
-#if WIDGET_TEXTBROWSER
-    void setText(TextBrowser *textbrowser, std::string text, bool suppressSignals);
-    void setUrl(TextBrowser *textbrowser, std::string url);
-#endif
-
-#if WIDGET_SCENE3D
-    void addScene3DNode(Scene3D *scene3d, int id, int parentId, int type);
-    void removeScene3DNode(Scene3D *scene3d, int id);
-    void setScene3DNodeEnabled(Scene3D *scene3d, int id, bool enabled);
-    void setScene3DIntParam(Scene3D *scene3d, int id, std::string param, int value);
-    void setScene3DFloatParam(Scene3D *scene3d, int id, std::string param, float value);
-    void setScene3DStringParam(Scene3D *scene3d, int id, std::string param, std::string value);
-    void setScene3DVector2Param(Scene3D *scene3d, int id, std::string param, float x, float y);
-    void setScene3DVector3Param(Scene3D *scene3d, int id, std::string param, float x, float y, float z);
-    void setScene3DVector4Param(Scene3D *scene3d, int id, std::string param, float x, float y, float z, float w);
-#endif
+public:
+    /**
+     * execute a UI slot in the UI thread, e.g.:
+     *
+     *     SIM::getInstance()->call(slider, UI_SLOT(onSetSliderValue), value, suppressEvents);
+     *
+     * the target (a Widget or a Window) is passed as the first argument of
+     * the slot; the name of the slot (see UI_SLOT) is used for the statistics
+     * (see simUI.getStats); if the UI has been created with async="true",
+     * this returns immediately and the command is executed later (in order),
+     * otherwise it waits until the command has been executed
+     */
+    template<typename T, typename U, typename... Params, typename... Args>
+    void call(T *target, void (UI::*slot)(U*, Params...), const char *name, Args&&... args)
+    {
+        enqueue(target, Property::None, name, std::bind(slot, UI::getInstance(), static_cast<U*>(target), std::forward<Args>(args)...), true, false);
+    }
+
+    /**
+     * same as call(...), for setters which replace entirely the given property
+     * of the target: if an update of the same property is still pending, it
+     * is discarded (only the last value is applied)
+     */
+    template<typename T, typename U, typename... Params, typename... Args>
+    void update(T *target, Property property, void (UI::*slot)(U*, Params...), const char *name, Args&&... args)
+    {
+        enqueue(target, property, name, std::bind(slot, UI::getInstance(), static_cast<U*>(target), std::forward<Args>(args)...), true, false);
+    }
+
+    /**
+     * same as call(...), but always waits for the command to be executed;
+     * used for commands that modify some state validated in the SIM thread
+     * by subsequent calls (e.g. the list of curves of a plot)
+     */
+    template<typename T, typename U, typename... Params, typename... Args>
+    void callSync(T *target, void (UI::*slot)(U*, Params...), const char *name, Args&&... args)
+    {
+        enqueue(target, Property::None, name, std::bind(slot, UI::getInstance(), static_cast<U*>(target), std::forward<Args>(args)...), false, false);
+    }
+
+    /**
+     * same as call(...), for bulk data (e.g. plot points, table items, image
+     * frames): with async="true", the command is executed only after the
+     * other pending commands (window visibility, button states, ...), so
+     * that these are not delayed by a long queue of data; commands for the
+     * same target are still executed in order
+     */
+    template<typename T, typename U, typename... Params, typename... Args>
+    void callBulk(T *target, void (UI::*slot)(U*, Params...), const char *name, Args&&... args)
+    {
+        enqueue(target, Property::None, name, std::bind(slot, UI::getInstance(), static_cast<U*>(target), std::forward<Args>(args)...), true, true);
+    }
+
+    /**
+     * same as update(...), for bulk data (see callBulk): under load, the
+     * pending updates are dropped in favour of the latest one
+     */
+    template<typename T, typename U, typename... Params, typename... Args>
+    void updateBulk(T *target, Property property, void (UI::*slot)(U*, Params...), const char *name, Args&&... args)
+    {
+        enqueue(target, property, name, std::bind(slot, UI::getInstance(), static_cast<U*>(target), std::forward<Args>(args)...), true, true);
+    }
+
+    void beginBatch(Proxy *proxy);
+    void commitBatch(Proxy *proxy);
+
+    /**
+     * create the Qt widgets of the UI without waiting for the UI thread (see
+     * simUI.createAsync): until the UI is ready, its setters are queued
+     * after the creation, as if it had async="true"
+     */
+    void createAsync(Proxy *proxy);
+
+    // replaces the widgets of the UI with those of window, but the ones
+    // whose id is in unchanged (see Window::updateStructure); waits for the
+    // UI thread:
+    void updateStructure(Proxy *proxy, Window *window, std::map<int, Widget*> &widgets, std::set<int> &unchanged);
+
+    // moves the events recorded for simUI.pollEvents into events:
+    void takeEvents(Proxy *proxy, std::vector<event_info> &events);
+
+    // default for the async attribute of <ui>; read from the named param 'simUI.async'
+    static bool asyncByDefault();
 
-#if WIDGET_SVG
-    void svgLoadFile(SVG *svg, const QString &file);
-    void svgLoadData(SVG *svg, const QByteArray &data);
+private:
+    void enqueue(Widget *widget, Property property, const char *name, CommandFunction f, bool deferrable, bool bulk);
+    void enqueue(Window *window, Property property, const char *name, CommandFunction f, bool deferrable, bool bulk);
+    void enqueue(Proxy *proxy, Command &&cmd, bool deferrable);
+    Command takeBatch(Proxy *proxy);
+    CommandRing & push(Command &&cmd);
+
+    // target -> sequence number (in UI::bulkCommands) of its last bulk
+    // command; the NULL target stands for batches
+    CommandIndex lastBulk;
+
+    // sequence number of the last bulk command which could not be recorded
+    // in lastBulk (CommandIndex::npos if none)
+    std::size_t lastUntrackedBulk;
+
+    // high-frequency events (value changes, mouse moves) for which only the
+    // latest occurrence per widget is delivered:
+    enum class CoalescedEventType
+    {
+        ValueChange,
+        MouseMove
+    };
+
+    struct CoalescedEvent
+    {
+        WidgetRef widget;
+        CoalescedEventType type;
+        CommandFunction deliver;
+    };
+
+    bool coalesceEvent(Widget *widget, CoalescedEventType type, CommandFunction deliver);
+    void flushCoalescedEvents();
+
+    std::vector<CoalescedEvent> coalescedEvents;
+    std::map<std::pair<WidgetRef, CoalescedEventType>, std::size_t> coalescedEventIndex;
+
+    // callbacks limited by the event-rate-limit attribute:
+    enum class ThrottledEventType
+    {
+        Change,
+        MouseMove
+    };
+
+    struct ThrottledEvent
+    {
+        std::chrono::steady_clock::time_point lastDelivery;
+        CommandFunction pending;
+        bool timerActive;
+        bool delivering;
+    };
+
+    typedef std::pair<WidgetRef, ThrottledEventType> ThrottledEventKey;
+
+    bool throttleEvent(Widget *widget, ThrottledEventType type, CommandFunction deliver);
+    void startThrottleTimer(ThrottledEventKey key, ThrottledEvent &t, int ms);
+    void deliverThrottledEvent(ThrottledEventKey key);
+
+    std::map<ThrottledEventKey, ThrottledEvent> throttledEvents;
+
+    // records an event for simUI.pollEvents (instead of calling the callback):
+    void queueEvent(Proxy *proxy, const event_info &event);
+
+    // the actual callbacks of the slots above:
+    void valueChangeInt(WidgetRef widgetRef, int value);
+    void valueChangeDouble(WidgetRef widgetRef, double value);
+    void valueChangeString(WidgetRef widgetRef, QString value);
+
+#if WIDGET_IMAGE || WIDGET_SVG
+    void mouseEvent(WidgetRef widgetRef, int type, bool shift, bool control, int x, int y);
 #endif
 };
 
@@ -0,0 +1,111 @@
+#ifndef SLOTTABLE_H_INCLUDED
+#define SLOTTABLE_H_INCLUDED
+
+#include "config.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <QtGlobal>
+
+/**
+ * a table of references to objects of type T (see WidgetRef, WindowRef),
+ * which can be safely passed across threads and resolved (in constant time)
+ * even after the object has been deleted: a reference is made of the index of
+ * the object in the table, and of the generation of that slot, which changes
+ * when the object is released, so that a stale reference never resolves to an
+ * object acquired later in the same slot; 0 is the null reference
+ *
+ * slots are allocated in chunks which are never moved nor freed, so that a
+ * reference can be resolved from any thread without locking; only acquiring
+ * and releasing a slot is serialized
+ */
+template<typename T>
+class SlotTable
+{
+private:
+    struct Slot
+    {
+        std::atomic<T *> object;
+        std::atomic<quint32> generation;
+    };
+
+    static const quint32 slotsPerChunk = 1024;
+    static const quint32 maxChunks = 4096;
+    static std::atomic<Slot *> chunks[maxChunks];
+    static std::mutex mutex;
+    static std::vector<quint32> freeSlots;
+    static quint32 numSlots;
+
+public:
+    static quint64 acquire(T *object)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        quint32 index;
+        if(!freeSlots.empty())
+        {
+            index = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        else
+        {
+            if(numSlots == slotsPerChunk * maxChunks)
+                throw std::runtime_error("too many objects");
+            index = numSlots++;
+            if(index % slotsPerChunk == 0)
+                chunks[index / slotsPerChunk].store(new Slot[slotsPerChunk](), std::memory_order_release);
+        }
+
+        Slot &slot = chunks[index / slotsPerChunk].load(std::memory_order_relaxed)[index % slotsPerChunk];
+        // generation 0 is reserved for the null reference:
+        quint32 generation = slot.generation.load(std::memory_order_relaxed);
+        if(generation == 0) generation = 1;
+        slot.object.store(object, std::memory_order_relaxed);
+        slot.generation.store(generation, std::memory_order_release);
+        return (quint64(generation) << 32) | index;
+    }
+
+    // invalidates all the references to the object:
+    static void release(quint64 ref)
+    {
+        if(!ref) return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        quint32 index = ref & 0xffffffff;
+        Slot &slot = chunks[index / slotsPerChunk].load(std::memory_order_relaxed)[index % slotsPerChunk];
+        slot.generation.store(slot.generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        slot.object.store(NULL, std::memory_order_relaxed);
+        freeSlots.push_back(index);
+    }
+
+    // returns NULL if the object has been released:
+    static T * resolve(quint64 ref)
+    {
+        quint32 index = ref & 0xffffffff, generation = ref >> 32;
+        if(generation == 0 || index >= slotsPerChunk * maxChunks) return NULL;
+
+        Slot *chunk = chunks[index / slotsPerChunk].load(std::memory_order_acquire);
+        if(!chunk) return NULL;
+        Slot &slot = chunk[index % slotsPerChunk];
+        if(slot.generation.load(std::memory_order_acquire) != generation) return NULL;
+        return slot.object.load(std::memory_order_relaxed);
+    }
+};
+
+template<typename T>
+std::atomic<typename SlotTable<T>::Slot *> SlotTable<T>::chunks[SlotTable<T>::maxChunks];
+
+template<typename T>
+std::mutex SlotTable<T>::mutex;
+
+template<typename T>
+std::vector<quint32> SlotTable<T>::freeSlots;
+
+template<typename T>
+quint32 SlotTable<T>::numSlots = 0;
+
+#endif // SLOTTABLE_H_INCLUDED
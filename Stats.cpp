@@ -0,0 +1,132 @@
+#include "Stats.h"
+
+#include <algorithm>
+
+#include "Proxy.h"
+#include "Trace.h"
+#include "widgets/Widget.h"
+
+std::atomic<bool> Stats::enabled(false);
+std::mutex Stats::mutex;
+std::map<Stats::Key, Stats::Histogram> Stats::histograms;
+
+Stats::Histogram::Histogram()
+    : count(0),
+      total(0),
+      min(0),
+      max(0)
+{
+    std::fill(buckets, buckets + numBuckets, 0);
+}
+
+void Stats::Histogram::add(double us)
+{
+    if(count == 0 || us < min) min = us;
+    if(count == 0 || us > max) max = us;
+    count++;
+    total += us;
+
+    int i = 0;
+    for(double b = 1; us >= b && i < numBuckets - 1; b *= 2) i++;
+    buckets[i]++;
+}
+
+void Stats::Histogram::merge(const Histogram &h)
+{
+    if(h.count == 0) return;
+    if(count == 0 || h.min < min) min = h.min;
+    if(count == 0 || h.max > max) max = h.max;
+    count += h.count;
+    total += h.total;
+    for(int i = 0; i < numBuckets; i++)
+        buckets[i] += h.buckets[i];
+}
+
+void Stats::setEnabled(bool enabled_)
+{
+    enabled = enabled_;
+}
+
+void Stats::record(Kind kind, const char *name, Widget *widget, Clock::duration t)
+{
+    if(!isEnabled()) return;
+    if(widget && widget->proxy)
+        record(kind, name, widget->proxy->handle, widget->id, t);
+    else
+        record(kind, name, std::string(), 0, t);
+}
+
+void Stats::record(Kind kind, const char *name, const std::string &handle, int id, Clock::duration t)
+{
+    if(!isEnabled()) return;
+
+    double us = std::chrono::duration<double, std::micro>(t).count();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    histograms[Key(kind, name, std::string(), 0)].add(us);
+    if(!handle.empty())
+        histograms[Key(kind, name, handle, id)].add(us);
+}
+
+const char * Stats::kindName(Kind kind)
+{
+    static const char *kindNames[] = {"queue-wait", "slot-execution", "sim-blocked", "callback"};
+    return kindNames[kind];
+}
+
+void Stats::get(std::vector<stats_entry> &entries)
+{
+    // the same name may be a different literal in each translation unit:
+    std::map<std::tuple<Kind, std::string, std::string, int>, Histogram> merged;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for(const auto &x : histograms)
+            merged[std::make_tuple(std::get<0>(x.first), std::string(std::get<1>(x.first)), std::get<2>(x.first), std::get<3>(x.first))].merge(x.second);
+    }
+
+    for(const auto &x : merged)
+    {
+        const Histogram &h = x.second;
+        stats_entry entry;
+        entry.kind = kindName(std::get<0>(x.first));
+        entry.name = std::get<1>(x.first);
+        entry.handle = std::get<2>(x.first);
+        entry.id = std::get<3>(x.first);
+        entry.count = h.count;
+        entry.total = h.total;
+        entry.min = h.min;
+        entry.max = h.max;
+        entry.mean = h.total / h.count;
+        entry.histogram.assign(h.buckets, h.buckets + Histogram::numBuckets);
+        entries.push_back(entry);
+    }
+}
+
+void Stats::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    histograms.clear();
+}
+
+StatsTimer::StatsTimer(Stats::Kind kind_, const char *name_, Widget *widget)
+    : active(Stats::isEnabled() || Trace::isEnabled()),
+      kind(kind_),
+      name(name_),
+      id(0)
+{
+    if(!active) return;
+    if(Stats::isEnabled() && widget && widget->proxy)
+    {
+        handle = widget->proxy->handle;
+        id = widget->id;
+    }
+    start = Stats::Clock::now();
+}
+
+StatsTimer::~StatsTimer()
+{
+    if(!active) return;
+    Stats::Clock::time_point end = Stats::Clock::now();
+    Stats::record(kind, name, handle, id, end - start);
+    Trace::complete(Stats::kindName(kind), name, start, end);
+}
@@ -0,0 +1,102 @@
+#ifndef STATS_H_INCLUDED
+#define STATS_H_INCLUDED
+
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "stubs.h"
+
+class Widget;
+
+/**
+ * latency statistics of the cross-thread traffic (see simUI.getStats):
+ * samples are recorded from both the SIM and the UI thread, and grouped by
+ * what is measured (kind), by command or callback name, and by widget;
+ * nothing is recorded unless enabled (see simUI.setStatsEnabled)
+ */
+class Stats
+{
+public:
+    enum Kind
+    {
+        // (UI thread) time between the enqueue of a command and its execution
+        QueueWait,
+        // (UI thread) execution time of a command
+        SlotExecution,
+        // (SIM thread) time spent waiting for the UI thread to execute commands
+        SimBlocked,
+        // (SIM thread) execution time of a Lua callback
+        Callback
+    };
+
+    typedef std::chrono::steady_clock Clock;
+
+    static void setEnabled(bool enabled);
+    static inline bool isEnabled() {return enabled.load(std::memory_order_relaxed);}
+
+    static const char * kindName(Kind kind);
+
+    static void record(Kind kind, const char *name, Widget *widget, Clock::duration t);
+    static void record(Kind kind, const char *name, const std::string &handle, int id, Clock::duration t);
+
+    // returns the statistics (one entry per kind and name, and one per
+    // kind, name and widget), in no particular order
+    static void get(std::vector<stats_entry> &entries);
+
+    static void reset();
+
+private:
+    // a log2 histogram of durations, in microseconds: bucket 0 counts the
+    // samples under 1us, bucket i those in [2^(i-1), 2^i) us, and the last
+    // bucket everything above
+    struct Histogram
+    {
+        static const int numBuckets = 24;
+
+        Histogram();
+        void add(double us);
+        void merge(const Histogram &h);
+
+        unsigned long count;
+        double total, min, max;
+        unsigned long buckets[numBuckets];
+    };
+
+    // (kind, name, ui handle, widget id) -> histogram; the ui handle is
+    // empty for the totals of each kind and name; names are string literals
+    // (see UI_SLOT), compared by address (and merged by value in get())
+    typedef std::tuple<Kind, const char *, std::string, int> Key;
+
+    static std::atomic<bool> enabled;
+    static std::mutex mutex;
+    static std::map<Key, Histogram> histograms;
+};
+
+/**
+ * records the time elapsed between its construction and its destruction
+ * (also in the trace, see Trace), if the statistics or the trace are enabled;
+ * the widget may be deleted in the meantime (e.g. by a Lua callback)
+ */
+class StatsTimer
+{
+public:
+    StatsTimer(Stats::Kind kind, const char *name, Widget *widget = NULL);
+    ~StatsTimer();
+
+private:
+    bool active;
+    Stats::Kind kind;
+    const char *name;
+    std::string handle;
+    int id;
+    Stats::Clock::time_point start;
+};
+
+#endif // STATS_H_INCLUDED
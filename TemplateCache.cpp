@@ -0,0 +1,78 @@
+#include "TemplateCache.h"
+
+#include <functional>
+#include <stdexcept>
+
+#include "tinyxml2.h"
+#include "widgets/Window.h"
+
+#include <simPlusPlus/Lib.h>
+
+std::list<TemplateCache::Entry> TemplateCache::entries;
+std::unordered_map<std::size_t, std::list<TemplateCache::Entry>::iterator> TemplateCache::index;
+
+Window * TemplateCache::instantiate(const std::string &xml, std::map<int, Widget*> &widgets)
+{
+    std::size_t hash = std::hash<std::string>()(xml);
+    auto it = index.find(hash);
+    if(it != index.end() && it->second->xml == xml)
+    {
+        entries.splice(entries.begin(), entries, it->second);
+        return it->second->prototype->clone(widgets);
+    }
+
+    Window *prototype = parse(xml);
+
+    // on a hash collision, the older entry is replaced:
+    if(it != index.end())
+    {
+        delete it->second->prototype;
+        entries.erase(it->second);
+        index.erase(it);
+    }
+
+    entries.push_front(Entry{xml, prototype});
+    index[hash] = entries.begin();
+
+    if(entries.size() > capacity)
+    {
+        index.erase(std::hash<std::string>()(entries.back().xml));
+        delete entries.back().prototype;
+        entries.pop_back();
+    }
+
+    sim::addLog(sim_verbosity_debug, "cached UI template (%d entries)", entries.size());
+
+    return prototype->clone(widgets);
+}
+
+void TemplateCache::clear()
+{
+    for(Entry &entry : entries)
+        delete entry.prototype;
+    entries.clear();
+    index.clear();
+}
+
+Window * TemplateCache::parse(const std::string &xml)
+{
+    tinyxml2::XMLDocument xmldoc;
+    tinyxml2::XMLError error = xmldoc.Parse(xml.c_str(), xml.size());
+
+    if(error != tinyxml2::XML_NO_ERROR)
+        throw std::runtime_error("XML parse error");
+
+    tinyxml2::XMLElement *rootElement = xmldoc.FirstChildElement();
+    std::map<int, Widget*> widgets;
+    Window *window = new Window;
+    try
+    {
+        window->parse(widgets, rootElement);
+    }
+    catch(std::exception& ex)
+    {
+        delete window;
+        throw;
+    }
+    return window;
+}
@@ -0,0 +1,47 @@
+#ifndef TEMPLATECACHE_H_INCLUDED
+#define TEMPLATECACHE_H_INCLUDED
+
+#include "config.h"
+
+#include <cstddef>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+class Widget;
+class Window;
+
+/**
+ * the widget trees parsed from the XML of the most recently created UIs: a UI
+ * created again with the same XML (e.g. one panel per robot, or a UI created
+ * at each simulation start) is cloned from the cached tree, without parsing
+ * and validating the XML again
+ */
+class TemplateCache
+{
+public:
+    // returns a new (not yet created) window for the given XML, and its widgets
+    // by id:
+    static Window * instantiate(const std::string &xml, std::map<int, Widget*> &widgets);
+
+    static void clear();
+
+private:
+    static Window * parse(const std::string &xml);
+
+    struct Entry
+    {
+        std::string xml;
+        Window *prototype;
+    };
+
+    static const std::size_t capacity = 32;
+
+    // most recently used first:
+    static std::list<Entry> entries;
+    // hash of the XML -> entry:
+    static std::unordered_map<std::size_t, std::list<Entry>::iterator> index;
+};
+
+#endif // TEMPLATECACHE_H_INCLUDED
@@ -0,0 +1,84 @@
+#include "Trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <stdexcept>
+
+#include <QThread>
+
+#include <simPlusPlus/Lib.h>
+
+const std::size_t Trace::capacity;
+std::atomic<bool> Trace::enabled(false);
+std::mutex Trace::mutex;
+std::vector<Trace::Event> Trace::events;
+std::size_t Trace::count = 0;
+
+void Trace::setEnabled(bool enabled_)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(enabled_ && events.empty())
+        events.resize(capacity);
+    enabled = enabled_;
+}
+
+void Trace::complete(const char *category, const char *name, Clock::time_point start, Clock::time_point end)
+{
+    if(!isEnabled()) return;
+    record(Event{category, name, 'X', QThread::currentThreadId() == UI_THREAD, start, end - start});
+}
+
+void Trace::instant(const char *category, const char *name)
+{
+    if(!isEnabled()) return;
+    record(Event{category, name, 'i', QThread::currentThreadId() == UI_THREAD, Clock::now(), Clock::duration::zero()});
+}
+
+void Trace::record(const Event &event)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(events.empty()) return;
+    events[count++ % capacity] = event;
+}
+
+void Trace::dump(const std::string &filename)
+{
+    std::vector<Event> evts;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::size_t n = std::min(count, capacity);
+        evts.reserve(n);
+        for(std::size_t i = count - n; i < count; i++)
+            evts.push_back(events[i % capacity]);
+    }
+
+    std::ofstream f(filename);
+    if(!f)
+        throw std::runtime_error("cannot open file " + filename);
+    f << std::fixed << std::setprecision(3);
+
+    // timestamps are in microseconds, relative to the oldest event (events
+    // are recorded when they end, so the first one is not necessarily the
+    // oldest):
+    Clock::time_point t0 = Clock::time_point::max();
+    for(const Event &e : evts)
+        t0 = std::min(t0, e.start);
+    auto us = [](Clock::duration d) {return std::chrono::duration<double, std::micro>(d).count();};
+
+    f << "{\"traceEvents\":[" << std::endl;
+    f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"SIM\"}}," << std::endl;
+    f << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"UI\"}}";
+    for(const Event &e : evts)
+    {
+        f << "," << std::endl;
+        f << "{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"" << e.phase << "\"";
+        f << ",\"ts\":" << us(e.start - t0);
+        if(e.phase == 'X')
+            f << ",\"dur\":" << us(e.duration);
+        else
+            f << ",\"s\":\"t\"";
+        f << ",\"pid\":1,\"tid\":" << (e.uiThread ? 2 : 1) << "}";
+    }
+    f << std::endl << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+}
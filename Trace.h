@@ -0,0 +1,57 @@
+#ifndef TRACE_H_INCLUDED
+#define TRACE_H_INCLUDED
+
+#include "config.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * a tracer of the interaction between the SIM and the UI thread (SIM emits,
+ * execution of UI commands, Lua callbacks, replots); when enabled (see
+ * simUI.setTraceEnabled), events are recorded into an in-memory ring, which
+ * can be saved in the Chrome trace-event format (see simUI.dumpTrace)
+ */
+class Trace
+{
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    static void setEnabled(bool enabled);
+    static inline bool isEnabled() {return enabled.load(std::memory_order_relaxed);}
+
+    // a span of time (category and name must be string literals):
+    static void complete(const char *category, const char *name, Clock::time_point start, Clock::time_point end);
+
+    // a point in time (category and name must be string literals):
+    static void instant(const char *category, const char *name);
+
+    static void dump(const std::string &filename);
+
+private:
+    struct Event
+    {
+        const char *category;
+        const char *name;
+        char phase;
+        bool uiThread;
+        Clock::time_point start;
+        Clock::duration duration;
+    };
+
+    static void record(const Event &event);
+
+    static const std::size_t capacity = 65536;
+
+    static std::atomic<bool> enabled;
+    static std::mutex mutex;
+    static std::vector<Event> events;
+    // total number of events recorded (the ring holds the last capacity ones):
+    static std::size_t count;
+};
+
+#endif // TRACE_H_INCLUDED
@@ -1,6 +1,7 @@
 #include "UI.h"
 
 #include <QThread>
+#include <QTimer>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QWidget>
@@ -22,6 +23,8 @@
 #include <QTextBrowser>
 
 #include <simPlusPlus/Lib.h>
+#include "Stats.h"
+#include "Trace.h"
 #include "stubs.h"
 
 using namespace tinyxml2;
@@ -34,8 +37,11 @@ QWidget *UI::simMainWindow = NULL;
 
 simFloat UI::wheelZoomFactor = 1.0;
 
+std::atomic<int> UI::commandBudget(10);
+
 UI::UI(QObject *parent)
-    : QObject(parent)
+    : QObject(parent),
+      processCommandsScheduled(false)
 {
 }
 
@@ -218,247 +224,346 @@ void UI::onCreate(Proxy *proxy)
     TRACE_FUNC;
 
     proxy->createQtWidget(this);
-}
 
-// The following slots are directly connected to Qt Widgets' signals.
-// Here we look up the sender to find the corresponding Widget object,
-// and emit a signal with the Widget object pointer.
-//
-// That signal will be connected to a slot in SIM, such
-// that the callback is called from the SIM thread.
+    // SIM is blocked until we return, so the mirrored state is up to date
+    // when simUI.create returns; for an async creation, it is updated by
+    // the windowStateChange signal instead:
+    proxy->window->mirrorState();
+}
 
-#if WIDGET_BUTTON || WIDGET_RADIOBUTTON
-void UI::onButtonClick()
+void UI::onCreateAsync(Proxy *proxy)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    QWidget *qwidget = dynamic_cast<QWidget*>(sender());
-    if(qwidget)
+    proxy->createQtWidget(this);
+    emit windowReady(proxy->window->getRef());
+}
+
+void UI::onProcessCommands()
+{
+    ASSERT_THREAD(UI);
+
+    // commands are executed in slices of at most commandBudget ms; if some
+    // are left, we go back to the event loop (so that input is handled and
+    // widgets are repainted) and continue from there:
+    auto deadline = std::chrono::steady_clock::time_point::max();
+    if(int budget = commandBudget)
+        deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget);
+
+    // bulk data is processed only after the other commands:
+    auto run = [this](Command &cmd) {runCommand(cmd);};
+    bool done = commands.consume(run, deadline) && bulkCommands.consume(run, deadline);
+
+    if(!done && !processCommandsScheduled)
     {
-        Widget *widget = Widget::byQWidget(qwidget);
-        if(widget)
-        {
-            emit buttonClick(widget);
-        }
+        Trace::instant("ui", "yield");
+        processCommandsScheduled = true;
+        QTimer::singleShot(0, this, [this] {
+            processCommandsScheduled = false;
+            onProcessCommands();
+        });
     }
 }
-#endif
 
-#if WIDGET_LABEL
-void UI::onLinkActivated(const QString &link)
+void UI::onFlushCommands()
+{
+    ASSERT_THREAD(UI);
+
+    // SIM is waiting: everything is executed now
+    auto run = [this](Command &cmd) {runCommand(cmd);};
+    commands.consume(run);
+    bulkCommands.consume(run);
+}
+
+void UI::onApplyBatch(WindowRef windowRef, std::deque<Command> &cmds)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    QWidget *qwidget = dynamic_cast<QWidget*>(sender());
-    if(qwidget)
-    {
-        Widget *widget = Widget::byQWidget(qwidget);
-        if(widget)
-        {
-            emit linkActivated(widget, link);
-        }
-    }
+    Window *window = Window::byRef(windowRef);
+    if(!window || !window->getQWidget()) return;
+
+    // the window is laid out and repainted only once, after all the changes:
+    QWidget *qwidget = window->getQWidget();
+    qwidget->setUpdatesEnabled(false);
+    for(Command &cmd : cmds)
+        runCommand(cmd);
+    qwidget->setUpdatesEnabled(true);
 }
-#endif
 
-void UI::onValueChangeInt(int value)
+void UI::onUpdateStructure(WindowRef targetRef, Window *window, std::map<int, Widget*> &widgets, std::set<int> &unchanged)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    QWidget *qwidget = dynamic_cast<QWidget*>(sender());
-    if(qwidget)
+    // the window may have been destroyed after the command was enqueued,
+    // in which case the new widgets are discarded:
+    Window *target = Window::byRef(targetRef);
+    if(!target || !target->getQWidget() || !target->proxy)
     {
-        Widget *widget = Widget::byQWidget(qwidget);
-        if(widget)
+        delete window;
+        return;
+    }
+
+    // the window is laid out and repainted only once, after all the changes:
+    QWidget *qwidget = target->getQWidget();
+    qwidget->setUpdatesEnabled(false);
+    target->updateStructure(target->proxy, this, window, widgets, unchanged);
+    qwidget->setUpdatesEnabled(true);
+}
+
+void UI::runCommand(Command &cmd)
+{
+    // the command may have been superseded by a later one:
+    if(!cmd.run)
+        return;
+
+    // the widget (or the window) may have been deleted after the command
+    // was enqueued:
+    Widget *widget = Widget::byRef(cmd.widget);
+    if(cmd.widget && !widget)
+        return;
+    if(cmd.window && !Window::byRef(cmd.window))
+        return;
+
+    // the widget may be in a container whose contents have not been created
+    // yet (e.g. a tab never shown): setters are kept until then, anything else
+    // forces the creation:
+    if(widget && !widget->getQWidget() && widget->proxy)
+    {
+        if(cmd.property != Property::None)
         {
-            emit valueChangeInt(widget, value);
+            deferCommand(cmd);
+            return;
         }
+        widget->proxy->materialize(widget);
+    }
+
+    // (not set if the statistics were disabled when the command was enqueued)
+    if(cmd.enqueued != std::chrono::steady_clock::time_point())
+        Stats::record(Stats::QueueWait, cmd.name, widget, std::chrono::steady_clock::now() - cmd.enqueued);
+
+    // (the value change events caused by this command, or by the user from
+    // now on, are not older than the setters issued so far)
+    if(widget && cmd.mirrorSeq > widget->appliedMirrorSeq)
+        widget->appliedMirrorSeq = cmd.mirrorSeq;
+
+    try
+    {
+        StatsTimer timer(Stats::SlotExecution, cmd.name, widget);
+        cmd.run();
+    }
+    catch(std::exception &ex)
+    {
+        sim::addLog(sim_verbosity_errors, "%s", ex.what());
     }
 }
 
-void UI::onValueChangeDouble(double value)
+void UI::deferCommand(Command &cmd)
 {
-    ASSERT_THREAD(UI);
-    TRACE_FUNC;
-
-    QWidget *qwidget = dynamic_cast<QWidget*>(sender());
-    if(qwidget)
+    std::vector<Command> &cmds = deferredCommands[cmd.widget];
+    for(Command &c : cmds)
     {
-        Widget *widget = Widget::byQWidget(qwidget);
-        if(widget)
+        if(c.property == cmd.property)
         {
-            emit valueChangeDouble(widget, value);
+            CommandStats::merged++;
+            c = std::move(cmd);
+            return;
         }
     }
+    cmds.push_back(std::move(cmd));
 }
 
-void UI::onValueChangeString(QString value)
+void UI::runDeferredCommands()
 {
     ASSERT_THREAD(UI);
-    TRACE_FUNC;
 
-    QWidget *qwidget = dynamic_cast<QWidget*>(sender());
-    if(qwidget)
+    // a command may create more widgets (e.g. by changing the current tab),
+    // and get here again, so the commands to run are taken out first:
+    std::vector<Command> cmds;
+    for(auto it = deferredCommands.begin(); it != deferredCommands.end(); )
     {
-        Widget *widget = Widget::byQWidget(qwidget);
+        Widget *widget = Widget::byRef(it->first);
+        if(widget && !widget->getQWidget())
+        {
+            ++it;
+            continue;
+        }
         if(widget)
         {
-            emit valueChangeString(widget, value);
+            for(Command &cmd : it->second)
+                cmds.push_back(std::move(cmd));
         }
+        it = deferredCommands.erase(it);
     }
+
+    for(Command &cmd : cmds)
+        runCommand(cmd);
 }
 
-#if WIDGET_EDIT
-void UI::onEditingFinished()
+// The following slots are called by the Qt Widgets' signals, through
+// lambdas which capture the corresponding Widget object (see the
+// createQtWidget methods), and emit a signal with a reference to the
+// Widget object (see WidgetRef).
+//
+// That signal will be connected to a slot in SIM, such
+// that the callback is called from the SIM thread.
+
+#if WIDGET_BUTTON || WIDGET_RADIOBUTTON
+void UI::onButtonClick(Widget *widget)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    QLineEdit *qedit = dynamic_cast<QLineEdit*>(sender());
+    emit buttonClick(widget->getRef());
+}
+#endif
 
-    if(qedit)
-    {
-        QString text = qedit->text();
-        Edit *edit = dynamic_cast<Edit*>(Widget::byQWidget(qedit));
+#if WIDGET_LABEL
+void UI::onLinkActivated(Widget *widget, const QString &link)
+{
+    ASSERT_THREAD(UI);
+    TRACE_FUNC;
 
-        if(edit)
-        {
-            emit editingFinished(edit, text);
-        }
-    }
+    emit linkActivated(widget->getRef(), link);
 }
 #endif
 
-#if WIDGET_PLOT
-void UI::onPlottableClick(QCPAbstractPlottable *plottable, int index, QMouseEvent *event)
+void UI::onValueChangeInt(Widget *widget, int value)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    if(QWidget *qwidget = dynamic_cast<QWidget*>(sender()))
-    {
-        if(Plot *plot = dynamic_cast<Plot*>(Widget::byQWidget(qwidget)))
-        {
-            std::string name = plottable->name().toStdString();
+    emit valueChangeInt(widget->getRef(), value, widget->appliedMirrorSeq);
+}
 
-            float x = NAN, y = NAN;
-            if(QCPGraph *graph = dynamic_cast<QCPGraph*>(plottable))
-            {
-                QCPGraphData d = *graph->data()->at(index);
-                x = d.key;
-                y = d.value;
-            }
-            else if(QCPCurve *curve = dynamic_cast<QCPCurve*>(plottable))
-            {
-                QCPCurveData d = *curve->data()->at(index);
-                x = d.key;
-                y = d.value;
-            }
+void UI::onMirrorChangeInt(Widget *widget, int value)
+{
+    ASSERT_THREAD(UI);
+    TRACE_FUNC;
 
-            emit plottableClick(plot, name, index, x, y);
-        }
-    }
+    emit mirrorChangeInt(widget->getRef(), value, widget->appliedMirrorSeq);
 }
 
-void UI::onLegendClick(QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event)
+void UI::onValueChangeDouble(Widget *widget, double value)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    if(QWidget *qwidget = dynamic_cast<QWidget*>(sender()))
-    {
-        if(Plot *plot = dynamic_cast<Plot*>(Widget::byQWidget(qwidget)))
-        {
-            if(QCPPlottableLegendItem *item1 = dynamic_cast<QCPPlottableLegendItem*>(item))
-            {
-                QCPAbstractPlottable *plottable = item1->plottable();
+    emit valueChangeDouble(widget->getRef(), value, widget->appliedMirrorSeq);
+}
 
-                std::string name = plottable->name().toStdString();
+void UI::onValueChangeString(Widget *widget, QString value)
+{
+    ASSERT_THREAD(UI);
+    TRACE_FUNC;
 
-                emit legendClick(plot, name);
-            }
-        }
-    }
+    emit valueChangeString(widget->getRef(), value, widget->appliedMirrorSeq);
+}
+
+#if WIDGET_EDIT
+void UI::onEditingFinished(Edit *edit)
+{
+    ASSERT_THREAD(UI);
+    TRACE_FUNC;
+
+    QString text = static_cast<QLineEdit*>(edit->getQWidget())->text();
+    emit editingFinished(edit->getRef(), text);
 }
 #endif
 
-#if WIDGET_TABLE
-void UI::onCellActivate(int row, int col)
+#if WIDGET_PLOT
+void UI::onPlottableClick(Plot *plot, QCPAbstractPlottable *plottable, int index, QMouseEvent *event)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    QTableWidget *qwidget = dynamic_cast<QTableWidget*>(sender());
+    std::string name = plottable->name().toStdString();
 
-    if(qwidget)
+    float x = NAN, y = NAN;
+    if(QCPGraph *graph = qobject_cast<QCPGraph*>(plottable))
     {
-        QString text = qwidget->item(row, col)->text();
-        Table *table = dynamic_cast<Table*>(Widget::byQWidget(qwidget));
-        if(table)
-        {
-            emit cellActivate(table, row, col, text.toStdString());
-        }
+        QCPGraphData d = *graph->data()->at(index);
+        x = d.key;
+        y = d.value;
+    }
+    else if(QCPCurve *curve = qobject_cast<QCPCurve*>(plottable))
+    {
+        QCPCurveData d = *curve->data()->at(index);
+        x = d.key;
+        y = d.value;
     }
+
+    emit plottableClick(plot->getRef(), name, index, x, y);
 }
 
-void UI::onTableSelectionChange()
+void UI::onLegendClick(Plot *plot, QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    QTableWidget *qwidget = dynamic_cast<QTableWidget*>(sender());
+    if(QCPPlottableLegendItem *item1 = qobject_cast<QCPPlottableLegendItem*>(item))
+    {
+        QCPAbstractPlottable *plottable = item1->plottable();
+
+        std::string name = plottable->name().toStdString();
+
+        emit legendClick(plot->getRef(), name);
+    }
+}
+#endif
+
+#if WIDGET_TABLE
+void UI::onCellActivate(Table *table, int row, int col)
+{
+    ASSERT_THREAD(UI);
+    TRACE_FUNC;
+
+    QTableWidget *qwidget = static_cast<QTableWidget*>(table->getQWidget());
+    QString text = qwidget->item(row, col)->text();
+    emit cellActivate(table->getRef(), row, col, text.toStdString());
+}
+
+void UI::onTableSelectionChange(Table *table)
+{
+    ASSERT_THREAD(UI);
+    TRACE_FUNC;
 
-    if(qwidget)
+    QTableWidget *qwidget = static_cast<QTableWidget*>(table->getQWidget());
+    QList<QModelIndex> indexes = qwidget->selectionModel()->selectedIndexes();
+    int row = -1, column = -1;
+    if(indexes.size() >= 1)
     {
-        QList<QModelIndex> indexes = qwidget->selectionModel()->selectedIndexes();
-        int row = -1, column = -1;
-        if(indexes.size() >= 1)
-        {
-            row = indexes[0].row();
-            column = indexes[0].column();
-        }
-        if(indexes.size() > 1)
-        {
-            if(indexes[1].row() == row) column = -1;
-            if(indexes[1].column() == column) row = -1;
-        }
-        Table *table = dynamic_cast<Table*>(Widget::byQWidget(qwidget));
-        if(table)
-        {
-            emit tableSelectionChange(table, row, column);
-        }
+        row = indexes[0].row();
+        column = indexes[0].column();
+    }
+    if(indexes.size() > 1)
+    {
+        if(indexes[1].row() == row) column = -1;
+        if(indexes[1].column() == column) row = -1;
     }
+    emit tableSelectionChange(table->getRef(), row, column);
 }
 #endif
 
 #if WIDGET_TREE
-void UI::onTreeSelectionChange()
+void UI::onTreeSelectionChange(Tree *tree)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    QTreeWidget *qwidget = dynamic_cast<QTreeWidget*>(sender());
-
-    if(qwidget)
+    QTreeWidget *qwidget = static_cast<QTreeWidget*>(tree->getQWidget());
+    QList<QTreeWidgetItem*> s = qwidget->selectedItems();
+    int id = 0;
+    if(s.size() > 0)
     {
-        QList<QTreeWidgetItem*> s = qwidget->selectedItems();
-        int id = 0;
-        Tree *tree = dynamic_cast<Tree*>(Widget::byQWidget(qwidget));
-        if(s.size() > 0 && tree)
-        {
-            // FIXME: implement inverted index for this operation
-            for(std::map<int, QTreeWidgetItem*>::iterator it = tree->widgetItemById.begin(); it != tree->widgetItemById.end(); ++it)
-                if(it->second == s[0])
-                    id = it->first;
-        }
-        if(tree)
-        {
-            emit treeSelectionChange(tree, id);
-        }
+        // FIXME: implement inverted index for this operation
+        for(std::map<int, QTreeWidgetItem*>::iterator it = tree->widgetItemById.begin(); it != tree->widgetItemById.end(); ++it)
+            if(it->second == s[0])
+                id = it->first;
     }
+    emit treeSelectionChange(tree->getRef(), id);
 }
 #endif
 
@@ -468,38 +573,26 @@ void UI::onMouseEvent(Widget *widget, int type, bool shift, bool control, int x,
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    emit mouseEvent(widget, type, shift, control, x, y);
+    emit mouseEvent(widget->getRef(), type, shift, control, x, y);
 }
 #endif
 
 #if WIDGET_TEXTBROWSER
-void UI::onTextChanged()
+void UI::onTextChanged(TextBrowser *textbrowser)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    if(QTextBrowser *qtextbrowser = dynamic_cast<QTextBrowser*>(sender()))
-    {
-        if(TextBrowser *textbrowser = dynamic_cast<TextBrowser*>(Widget::byQWidget(qtextbrowser)))
-        {
-            std::string text = textbrowser->getText();
-            emit valueChangeString(textbrowser, QString::fromStdString(text));
-        }
-    }
+    std::string text = textbrowser->getText();
+    emit valueChangeString(textbrowser->getRef(), QString::fromStdString(text), textbrowser->appliedMirrorSeq);
 }
 
-void UI::onAnchorClicked(const QUrl &link)
+void UI::onAnchorClicked(TextBrowser *textbrowser, const QUrl &link)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    if(QTextBrowser *qtextbrowser = dynamic_cast<QTextBrowser*>(sender()))
-    {
-        if(TextBrowser *textbrowser = dynamic_cast<TextBrowser*>(Widget::byQWidget(qtextbrowser)))
-        {
-            emit linkActivated(textbrowser, link.url());
-        }
-    }
+    emit linkActivated(textbrowser->getRef(), link.url());
 }
 #endif
 
@@ -527,7 +620,7 @@ void UI::onScene3DObjectClicked(Qt3DRender::QPickEvent *pick)
             int objId = scene3d->nodeId(obj);
             if(objId)
             {
-                emit scene3DObjectClick(scene3d, objId);
+                emit scene3DObjectClick(scene3d->getRef(), objId);
             }
         }
         else
@@ -562,6 +655,10 @@ void UI::onDestroy(Proxy *proxy)
         sim::addLog(sim_verbosity_debug, "WARNING: proxy->window is NULL");
         return;
     }
+    // the pending commands (including the creation of a UI created with
+    // simUI.createAsync) are executed before the window is deleted, so that
+    // none of them is left to run on a deleted window:
+    onFlushCommands();
     if(!proxy->window->qwidget)
     {
         sim::addLog(sim_verbosity_debug, "WARNING: proxy->window->qwidget is NULL");
@@ -663,14 +760,14 @@ void UI::onSetWindowEnabled(Window *window, bool enabled)
 }
 
 #if WIDGET_IMAGE
-void UI::onSetImage(Image *image, const char *data, int w, int h)
+void UI::onSetImage(Image *image, ImageData data, int w, int h)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    sim::addLog(sim_verbosity_debug, "image=%x, data=%x, w=%d, h=%d", image, data, w, h);
+    sim::addLog(sim_verbosity_debug, "image=%x, data=%x, w=%d, h=%d", image, data.get(), w, h);
 
-    image->setImage(data, w, h);
+    image->setImage(data.get(), w, h);
 }
 #endif
 
@@ -775,12 +872,12 @@ void UI::onRemoveComboboxItem(Combobox *combobox, int index, bool suppressSignal
     combobox->removeItem(index, suppressSignals);
 }
 
-void UI::onSetComboboxItems(Combobox *combobox, std::vector<std::string> items, int index, bool suppressSignals)
+void UI::onSetComboboxItems(Combobox *combobox, Payload<std::vector<std::string>> items, int index, bool suppressSignals)
 {
     ASSERT_THREAD(UI);
     TRACE_FUNC;
 
-    combobox->setItems(items, index, suppressSignals);
+    combobox->setItems(*items, index, suppressSignals);
 }
 
 void UI::onSetComboboxSelectedIndex(Combobox *combobox, int index, bool suppressSignals)
@@ -811,6 +908,13 @@ void UI::onSetWidgetVisibility(Widget *widget, bool visible)
 
     if(!widget) return;
 
+    // the contents of a hidden group are created when it is first shown:
+    if(visible)
+    {
+        if(LayoutWidget *layoutWidget = dynamic_cast<LayoutWidget*>(widget))
+            layoutWidget->materialize();
+    }
+
     widget->getQWidget()->setVisible(visible);
 }
 
@@ -825,14 +929,14 @@ void UI::onAddCurve(Plot *plot, int type, std::string name, std::vector<int> col
     plot->addCurve(type, name, color, style, opts);
 }
 
-void UI::onAddCurveTimePoints(Plot *plot, std::string name, std::vector<double> x, std::vector<double> y)
+void UI::onAddCurveTimePoints(Plot *plot, std::string name, Payload<std::vector<double>> x, Payload<std::vector<double>> y)
 {
-    plot->addTimeData(name, x, y);
+    plot->addTimeData(name, *x, *y);
 }
 
-void UI::onAddCurveXYPoints(Plot *plot, std::string name, std::vector<double> t, std::vector<double> x, std::vector<double> y)
+void UI::onAddCurveXYPoints(Plot *plot, std::string name, Payload<std::vector<double>> t, Payload<std::vector<double>> x, Payload<std::vector<double>> y)
 {
-    plot->addXYData(name, t, x, y);
+    plot->addXYData(name, *t, *x, *y);
 }
 
 void UI::onClearCurve(Plot *plot, std::string name)
@@ -925,6 +1029,11 @@ void UI::onSetLegendVisibility(Plot *plot, bool visible)
 {
     plot->setLegendVisibility(visible);
 }
+
+void UI::onGetCurveData(Plot *plot, std::string name, std::vector<double> *x, std::vector<double> *y)
+{
+    plot->getCurveData(name, *x, *x, *y);
+}
 #endif
 
 #if WIDGET_TABLE
@@ -948,9 +1057,9 @@ void UI::onSetItem(Table *table, int row, int column, std::string text, bool sup
     table->setItem(row, column, text, suppressSignals);
 }
 
-void UI::onSetItemImage(Table *table, int row, int column, std::string data, int width, int height, bool suppressSignals)
+void UI::onSetItemImage(Table *table, int row, int column, Payload<std::string> data, int width, int height, bool suppressSignals)
 {
-    table->setItemImage(row, column, data, width, height, suppressSignals);
+    table->setItemImage(row, column, *data, width, height, suppressSignals);
 }
 
 void UI::onSetRowHeaderText(Table *table, int row, std::string text)
@@ -987,6 +1096,16 @@ void UI::onSetTableSelection(Table *table, int row, int column, bool suppressSig
 {
     table->setSelection(row, column, suppressSignals);
 }
+
+void UI::onGetItem(Table *table, int row, int column, std::string *text)
+{
+    *text = table->getItem(row, column);
+}
+
+void UI::onSaveStateTable(Table *table, std::string *state)
+{
+    *state = table->saveState();
+}
 #endif
 
 #if WIDGET_PROGRESSBAR
@@ -1061,6 +1180,16 @@ void UI::onExpandToDepth(Tree *tree, int depth, bool suppressSignals)
 {
     tree->expandToDepth(depth, suppressSignals);
 }
+
+void UI::onGetColumnCountTree(Tree *tree, int *count)
+{
+    *count = tree->getColumnCount();
+}
+
+void UI::onSaveStateTree(Tree *tree, std::string *state)
+{
+    *state = tree->saveState();
+}
 #endif
 
 #if WIDGET_TEXTBROWSER
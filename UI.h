@@ -3,12 +3,18 @@
 
 #include "config.h"
 
+#include <atomic>
+#include <deque>
 #include <map>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <QObject>
 #include <QString>
 #include <QWidget>
 
+#include "CommandQueue.h"
 #include "Proxy.h"
 #include "stubs.h"
 #include "widgets/all.h"
@@ -28,45 +34,77 @@ private:
 
     static UI *instance;
 
+    void runCommand(Command &cmd);
+
+    // setters of widgets whose Qt widget has not been created yet (see
+    // LayoutWidget::createQtWidgetLazily), by widget; only the last setter of
+    // each property is kept:
+    std::unordered_map<WidgetRef, std::vector<Command>> deferredCommands;
+    void deferCommand(Command &cmd);
+
+    // true if onProcessCommands() will be called again to process the backlog
+    bool processCommandsScheduled;
+
 public:
     static QWidget *simMainWindow;
     static simFloat wheelZoomFactor;
 
+    // commands enqueued by SIM (see SIM::call), executed by onProcessCommands()
+    CommandRing commands;
+
+    // bulk data commands (see SIM::callBulk), executed after the above
+    CommandRing bulkCommands;
+
+    // max time (in ms) onProcessCommands() spends executing commands before
+    // going back to the event loop; 0 means no limit (see simUI.setCommandBudget)
+    static std::atomic<int> commandBudget;
+
+    // runs the deferred setters of the widgets which have been created since
+    // (see LayoutWidget::materialize):
+    void runDeferredCommands();
+
 public slots:
     void onMsgBox(int type, int buttons, std::string title, std::string message, int *result);
     void onFileDialog(int type, std::string title, std::string startPath, std::string initName, std::string extName, std::string ext, bool native, std::vector<std::string> *result);
     void onColorDialog(std::vector<float> initColor, std::string title, bool showAlphaChannel, bool native, std::vector<float> *result);
     void onDestroy(Proxy *proxy);
     void onCreate(Proxy *proxy);
+    void onCreateAsync(Proxy *proxy);
+    void onProcessCommands();
+    void onFlushCommands();
+    void onApplyBatch(WindowRef windowRef, std::deque<Command> &cmds);
+    void onUpdateStructure(WindowRef targetRef, Window *window, std::map<int, Widget*> &widgets, std::set<int> &unchanged);
 
 #if WIDGET_BUTTON || WIDGET_RADIOBUTTON
-    void onButtonClick();
+    void onButtonClick(Widget *widget);
 #endif
 
 #if WIDGET_LABEL
-    void onLinkActivated(const QString &link);
+    void onLinkActivated(Widget *widget, const QString &link);
 #endif
 
-    void onValueChangeInt(int value);
-    void onValueChangeDouble(double value);
-    void onValueChangeString(QString value);
+    void onValueChangeInt(Widget *widget, int value);
+    void onValueChangeDouble(Widget *widget, double value);
+    void onValueChangeString(Widget *widget, QString value);
+    // a state change which is mirrored, but not an event for the script:
+    void onMirrorChangeInt(Widget *widget, int value);
 
 #if WIDGET_EDIT
-    void onEditingFinished();
+    void onEditingFinished(Edit *edit);
 #endif
 
 #if WIDGET_PLOT
-    void onPlottableClick(QCPAbstractPlottable *plottable, int index, QMouseEvent *event);
-    void onLegendClick(QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event);
+    void onPlottableClick(Plot *plot, QCPAbstractPlottable *plottable, int index, QMouseEvent *event);
+    void onLegendClick(Plot *plot, QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event);
 #endif
 
 #if WIDGET_TABLE
-    void onCellActivate(int row, int col);
-    void onTableSelectionChange();
+    void onCellActivate(Table *table, int row, int col);
+    void onTableSelectionChange(Table *table);
 #endif
 
 #if WIDGET_TREE
-    void onTreeSelectionChange();
+    void onTreeSelectionChange(Tree *tree);
 #endif
 
 #if WIDGET_IMAGE || WIDGET_SVG
@@ -74,8 +112,8 @@ public slots:
 #endif
 
 #if WIDGET_TEXTBROWSER
-    void onTextChanged();
-    void onAnchorClicked(const QUrl &link);
+    void onTextChanged(TextBrowser *textbrowser);
+    void onAnchorClicked(TextBrowser *textbrowser, const QUrl &link);
 #endif
 
 #if WIDGET_SCENE3D
@@ -101,7 +139,7 @@ public slots:
     void onSetWindowEnabled(Window *window, bool enabled);
 
 #if WIDGET_IMAGE
-    void onSetImage(Image *image, const char *data, int w, int h);
+    void onSetImage(Image *image, ImageData data, int w, int h);
 #endif
 
     void onSceneChange(Window *window, int oldSceneID, int newSceneID);
@@ -134,7 +172,7 @@ public slots:
 #if WIDGET_COMBOBOX
     void onInsertComboboxItem(Combobox *combobox, int index, std::string text, bool suppressSignals);
     void onRemoveComboboxItem(Combobox *combobox, int index, bool suppressSignals);
-    void onSetComboboxItems(Combobox *combobox, std::vector<std::string> items, int index, bool suppressSignals);
+    void onSetComboboxItems(Combobox *combobox, Payload<std::vector<std::string>> items, int index, bool suppressSignals);
     void onSetComboboxSelectedIndex(Combobox *combobox, int index, bool suppressSignals);
 #endif
 
@@ -147,8 +185,8 @@ public slots:
 #if WIDGET_PLOT
     void onReplot(Plot *plot);
     void onAddCurve(Plot *plot, int type, std::string name, std::vector<int> color, int style, curve_options *opts);
-    void onAddCurveTimePoints(Plot *plot, std::string name, std::vector<double> x, std::vector<double> y);
-    void onAddCurveXYPoints(Plot *plot, std::string name, std::vector<double> t, std::vector<double> x, std::vector<double> y);
+    void onAddCurveTimePoints(Plot *plot, std::string name, Payload<std::vector<double>> x, Payload<std::vector<double>> y);
+    void onAddCurveXYPoints(Plot *plot, std::string name, Payload<std::vector<double>> t, Payload<std::vector<double>> x, Payload<std::vector<double>> y);
     void onClearCurve(Plot *plot, std::string name);
     void onRemoveCurve(Plot *plot, std::string name);
     void onSetPlotRanges(Plot *plot, double xmin, double xmax, double ymin, double ymax);
@@ -164,6 +202,7 @@ public slots:
     void onRescaleAxesAll(Plot *plot, bool onlyEnlargeX, bool onlyEnlargeY);
     void onSetMouseOptions(Plot *plot, bool panX, bool panY, bool zoomX, bool zoomY);
     void onSetLegendVisibility(Plot *plot, bool visible);
+    void onGetCurveData(Plot *plot, std::string name, std::vector<double> *x, std::vector<double> *y);
 #endif
 
 #if WIDGET_TABLE
@@ -171,7 +210,7 @@ public slots:
     void onSetRowCount(Table *table, int count, bool suppressSignals);
     void onSetColumnCountTable(Table *table, int count, bool suppressSignals);
     void onSetItem(Table *table, int row, int column, std::string text, bool suppressSignals);
-    void onSetItemImage(Table *table, int row, int column, std::string data, int width, int height, bool suppressSignals);
+    void onSetItemImage(Table *table, int row, int column, Payload<std::string> data, int width, int height, bool suppressSignals);
     void onSetRowHeaderText(Table *table, int row, std::string text);
     void onSetColumnHeaderTextTable(Table *table, int column, std::string text);
     void onSetItemEditable(Table *table, int row, int column, bool editable);
@@ -179,6 +218,8 @@ public slots:
     void onSetRowHeight(Table *table, int row, int min_size, int max_size);
     void onSetColumnWidthTable(Table *table, int column, int min_size, int max_size);
     void onSetTableSelection(Table *table, int row, int column, bool suppressSignals);
+    void onGetItem(Table *table, int row, int column, std::string *text);
+    void onSaveStateTable(Table *table, std::string *state);
 #endif
 
 #if WIDGET_PROGRESSBAR
@@ -199,6 +240,8 @@ public slots:
     void onExpandAll(Tree *tree, bool suppressSignals);
     void onCollapseAll(Tree *tree, bool suppressSignals);
     void onExpandToDepth(Tree *tree, int depth, bool suppressSignals);
+    void onGetColumnCountTree(Tree *tree, int *count);
+    void onSaveStateTree(Tree *tree, std::string *state);
 #endif
 
 #if WIDGET_TEXTBROWSER
@@ -224,44 +267,50 @@ public slots:
 #endif
 
 signals:
-    void buttonClick(Widget *widget);
-    void linkActivated(Widget *widget, QString link);
-    void valueChangeInt(Widget *widget, int value);
-    void valueChangeDouble(Widget *widget, double value);
-    void valueChangeString(Widget *widget, QString value);
+    // (widgets are passed by reference, as they may be deleted before the
+    // SIM thread processes the event, see WidgetRef)
+    void buttonClick(WidgetRef widget);
+    void linkActivated(WidgetRef widget, QString link);
+    // (with the Widget::appliedMirrorSeq of the widget)
+    void valueChangeInt(WidgetRef widget, int value, quint32 mirrorSeq);
+    void valueChangeDouble(WidgetRef widget, double value, quint32 mirrorSeq);
+    void valueChangeString(WidgetRef widget, QString value, quint32 mirrorSeq);
+    void mirrorChangeInt(WidgetRef widget, int value, quint32 mirrorSeq);
 
 #if WIDGET_EDIT
-    void editingFinished(Edit *edit, QString value);
+    void editingFinished(WidgetRef edit, QString value);
 #endif
 
-    void windowClose(Window *window);
+    void windowClose(WindowRef windowRef);
+    void windowReady(WindowRef windowRef);
+    void windowStateChange(WindowRef windowRef, bool visible, int x, int y, int w, int h);
 
 #if WIDGET_IMAGE
-    void loadImageFromFile(Image *image, const char *filename, int w, int h);
+    void loadImageFromFile(WidgetRef image, const char *filename, int w, int h);
 #endif
 
 #if WIDGET_IMAGE || WIDGET_SVG
-    void mouseEvent(Widget *widget, int type, bool shift, bool control, int x, int y);
+    void mouseEvent(WidgetRef widget, int type, bool shift, bool control, int x, int y);
 #endif
 
 #if WIDGET_PLOT
-    void plottableClick(Plot *plot, std::string name, int index, double x, double y);
-    void legendClick(Plot *plot, std::string name);
+    void plottableClick(WidgetRef plot, std::string name, int index, double x, double y);
+    void legendClick(WidgetRef plot, std::string name);
 #endif
 
 #if WIDGET_TABLE
-    void cellActivate(Table *table, int row, int col, std::string value);
-    void tableSelectionChange(Table *table, int row, int col);
+    void cellActivate(WidgetRef table, int row, int col, std::string value);
+    void tableSelectionChange(WidgetRef table, int row, int col);
 #endif
 
 #if WIDGET_TREE
-    void treeSelectionChange(Tree *tree, int id);
+    void treeSelectionChange(WidgetRef tree, int id);
 #endif
 
-    void keyPressed(Widget *widget, int key, std::string text);
+    void keyPressed(WidgetRef widget, int key, std::string text);
 
 #if WIDGET_SCENE3D
-    void scene3DObjectClick(Scene3D *scene3d, int id);
+    void scene3DObjectClick(WidgetRef scene3d, int id);
 #endif
 };
 
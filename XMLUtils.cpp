@@ -1,5 +1,6 @@
 #include "XMLUtils.h"
 
+#include <algorithm>
 #include <sstream>
 #include <cstring>
 #include <stdexcept>
@@ -15,28 +16,156 @@
 
 static std::set<std::string> repDepNames;
 
-#define REPORT_DEPRECATED_ATTRIB_NAME(dname, name)      \
-    if(repDepNames.find(dname) == repDepNames.end())    \
-    {                                                   \
-        std::stringstream ss;                           \
-        ss << "attribute name '" << dname               \
-           << "' is deprecated. please use '" << name   \
-           << "' instead.";                             \
-        sim::addLog(sim_verbosity_warnings, ss.str().c_str());  \
-        repDepNames.insert(dname);                      \
+namespace xmlutils
+{
+    // the attributes of the elements being parsed: resetKnownAttributes()
+    // pushes a frame with one entry per attribute, collected in one pass and
+    // sorted by name, so that each lookup is a binary search; an attribute is
+    // known once it has been read (see getUnknownAttributes)
+    struct AttributeEntry
+    {
+        const char *name;
+        const char *value;
+        bool known;
+    };
+
+    struct AttributeFrame
+    {
+        const tinyxml2::XMLElement *e;
+        // index of the first entry of the frame in attributeEntries (the
+        // frame ends where the next one begins):
+        std::size_t begin;
+    };
+
+    static std::vector<AttributeEntry> attributeEntries;
+    static std::vector<AttributeFrame> attributeFrames;
+
+    // compares a with b, ignoring the hyphens of b (hyphenate is false) or
+    // not (hyphenate is true), like strcmp
+    static int compareName(const char *a, const char *b, bool hyphenate)
+    {
+        for(;; a++, b++)
+        {
+            if(!hyphenate)
+                while(*b == '-') b++;
+            if(*a != *b || !*a)
+                return (unsigned char)*a - (unsigned char)*b;
+        }
+    }
+
+    static AttributeEntry * findEntry(std::size_t begin, std::size_t end, const char *name, bool hyphenate)
+    {
+        auto first = attributeEntries.begin() + begin, last = attributeEntries.begin() + end;
+        auto it = std::lower_bound(first, last, name, [=](const AttributeEntry &x, const char *n) {return compareName(x.name, n, hyphenate) < 0;});
+        if(it == last || compareName(it->name, name, hyphenate) != 0)
+            return NULL;
+        return &*it;
+    }
+
+    // true if dname is name with the hyphens stripped
+    static bool equalsStripped(const char *dname, const char *name)
+    {
+        return compareName(dname, name, false) == 0;
+    }
+
+    static void reportDeprecatedAttribute(const char *dname, const char *name)
+    {
+        if(repDepNames.find(dname) == repDepNames.end())
+        {
+            std::stringstream ss;
+            ss << "attribute name '" << dname
+               << "' is deprecated. please use '" << name
+               << "' instead.";
+            sim::addLog(sim_verbosity_warnings, ss.str().c_str());
+            repDepNames.insert(dname);
+        }
+    }
+
+    // looks up an attribute (or its deprecated hyphen-less name), and marks
+    // it as known; returns NULL if the attribute is missing
+    static const char * findAttr(tinyxml2::XMLElement *e, const char *name)
+    {
+        bool hyphens = std::strchr(name, '-');
+
+        for(std::size_t i = attributeFrames.size(); i > 0; i--)
+        {
+            if(attributeFrames[i - 1].e != e) continue;
+
+            std::size_t begin = attributeFrames[i - 1].begin;
+            std::size_t end = i < attributeFrames.size() ? attributeFrames[i].begin : attributeEntries.size();
+            AttributeEntry *entry = findEntry(begin, end, name, true);
+            if(!entry && hyphens)
+            {
+                entry = findEntry(begin, end, name, false);
+                if(entry) reportDeprecatedAttribute(entry->name, name);
+            }
+            if(!entry)
+                return NULL;
+            entry->known = true;
+            return entry->value;
+        }
+
+        // the element is not being parsed (e.g. a child element read by its
+        // parent, see Table::parse): a plain scan
+        const tinyxml2::XMLAttribute *deprecated = NULL;
+        for(const tinyxml2::XMLAttribute *a = e->FirstAttribute(); a; a = a->Next())
+        {
+            if(std::strcmp(a->Name(), name) == 0)
+                return a->Value();
+            if(hyphens && !deprecated && equalsStripped(a->Name(), name))
+                deprecated = a;
+        }
+        if(!deprecated)
+            return NULL;
+        reportDeprecatedAttribute(deprecated->Name(), name);
+        return deprecated->Value();
+    }
+
+    template<typename T>
+    static std::vector<T> parseAttrV(const char *name, const char *value, int minLength, int maxLength, const char *sep)
+    {
+        try
+        {
+            std::vector<T> ret;
+            string2vector(value, ret, minLength, maxLength, sep);
+            return ret;
+        }
+        catch(std::range_error &ex)
+        {
+            std::stringstream ss;
+            ss << "attribute '" << name << "' " << ex.what();
+            throw std::range_error(ss.str());
+        }
+    }
+
+    template<typename T>
+    static std::vector<T> getAttrV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep)
+    {
+        if(const char *value = findAttr(e, name))
+            return parseAttrV<T>(name, value, minLength, maxLength, sep);
+
+        std::vector<T> defaultValueV;
+        try
+        {
+            string2vector(defaultValue, defaultValueV, minLength, maxLength, sep);
+        }
+        catch(std::range_error &ex)
+        {
+            std::stringstream ss;
+            ss << "invalid default value for attribute '" << name << "': " << ex.what();
+            throw std::range_error(ss.str());
+        }
+        return defaultValueV;
     }
 
-#define CHECK_FOR_DEPRECATED_ATTRIB_NAME(name, value)   \
-    if(!value && containsHyphens(name))                 \
-    {                                                   \
-        std::string dname = stripHyphens(name);         \
-        value = e->Attribute(dname.c_str());            \
-        if(value)                                       \
-        {                                               \
-            REPORT_DEPRECATED_ATTRIB_NAME(dname, name); \
-            markKnownAttribute(dname);                  \
-        }                                               \
+    template<typename T>
+    static std::vector<T> getAttrV(tinyxml2::XMLElement *e, const char *name, const std::vector<T> &defaultValue, int minLength, int maxLength, const char *sep)
+    {
+        if(const char *value = findAttr(e, name))
+            return parseAttrV<T>(name, value, minLength, maxLength, sep);
+        return defaultValue;
     }
+};
 
 bool xmlutils::containsHyphens(const std::string &name)
 {
@@ -52,27 +181,19 @@ std::string xmlutils::stripHyphens(const std::string &name)
     return ret;
 }
 
-bool xmlutils::hasAttr(tinyxml2::XMLElement *e, std::string name)
+bool xmlutils::hasAttr(tinyxml2::XMLElement *e, const char *name)
 {
-    markKnownAttribute(name);
-
-    const char *value = e->Attribute(name.c_str());
-
-    CHECK_FOR_DEPRECATED_ATTRIB_NAME(name, value);
-
-    if(value) return true;
-    else return false;
+    return findAttr(e, name) != NULL;
 }
 
-bool xmlutils::getAttrBool(tinyxml2::XMLElement *e, std::string name, bool defaultValue)
+bool xmlutils::getAttrBool(tinyxml2::XMLElement *e, const char *name, bool defaultValue)
 {
-    if(!hasAttr(e, name)) return defaultValue;
-
-    std::string value = getAttrStr(e, name);
+    const char *value = findAttr(e, name);
+    if(!value) return defaultValue;
 
-    if(value == "true")
+    if(std::strcmp(value, "true") == 0)
         return true;
-    if(value == "false")
+    if(std::strcmp(value, "false") == 0)
         return false;
 
     std::stringstream ss;
@@ -80,40 +201,33 @@ bool xmlutils::getAttrBool(tinyxml2::XMLElement *e, std::string name, bool defau
     throw std::range_error(ss.str());
 }
 
-int xmlutils::getAttrInt(tinyxml2::XMLElement *e, std::string name, int defaultValue)
+int xmlutils::getAttrInt(tinyxml2::XMLElement *e, const char *name, int defaultValue)
 {
-    if(!hasAttr(e, name)) return defaultValue;
-
-    std::string value = getAttrStr(e, name);
+    const char *value = findAttr(e, name);
+    if(!value) return defaultValue;
 
     return boost::lexical_cast<int>(value);
 }
 
-float xmlutils::getAttrFloat(tinyxml2::XMLElement *e, std::string name, float defaultValue)
+float xmlutils::getAttrFloat(tinyxml2::XMLElement *e, const char *name, float defaultValue)
 {
-    if(!hasAttr(e, name)) return defaultValue;
-
-    std::string value = getAttrStr(e, name);
+    const char *value = findAttr(e, name);
+    if(!value) return defaultValue;
 
     return boost::lexical_cast<float>(value);
 }
 
-double xmlutils::getAttrDouble(tinyxml2::XMLElement *e, std::string name, double defaultValue)
+double xmlutils::getAttrDouble(tinyxml2::XMLElement *e, const char *name, double defaultValue)
 {
-    if(!hasAttr(e, name)) return defaultValue;
-
-    std::string value = getAttrStr(e, name);
+    const char *value = findAttr(e, name);
+    if(!value) return defaultValue;
 
     return boost::lexical_cast<double>(value);
 }
 
-std::string xmlutils::getAttrStr(tinyxml2::XMLElement *e, std::string name)
+std::string xmlutils::getAttrStr(tinyxml2::XMLElement *e, const char *name)
 {
-    markKnownAttribute(name);
-
-    const char *value = e->Attribute(name.c_str());
-
-    CHECK_FOR_DEPRECATED_ATTRIB_NAME(name, value);
+    const char *value = findAttr(e, name);
 
     if(!value)
     {
@@ -125,16 +239,15 @@ std::string xmlutils::getAttrStr(tinyxml2::XMLElement *e, std::string name)
     return std::string(value);
 }
 
-std::string xmlutils::getAttrStr(tinyxml2::XMLElement *e, std::string name, std::string defaultValue)
+std::string xmlutils::getAttrStr(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue)
 {
-    if(!hasAttr(e, name)) return defaultValue;
-
-    std::string value = getAttrStr(e, name);
+    const char *value = findAttr(e, name);
+    if(!value) return defaultValue;
 
-    return value;
+    return std::string(value);
 }
 
-void xmlutils::string2vector(std::string s, std::vector<std::string>& v, int minLength, int maxLength, const char *sep)
+void xmlutils::string2vector(const std::string &s, std::vector<std::string>& v, int minLength, int maxLength, const char *sep)
 {
     boost::char_separator<char> bsep(sep);
     boost::tokenizer< boost::char_separator<char> > tokenizer(s, bsep);
@@ -167,7 +280,7 @@ void xmlutils::string2vector(std::string s, std::vector<std::string>& v, int min
     }
 }
 
-void xmlutils::string2vector(std::string s, std::vector<bool>& v, int minLength, int maxLength, const char *sep)
+void xmlutils::string2vector(const std::string &s, std::vector<bool>& v, int minLength, int maxLength, const char *sep)
 {
     std::vector<std::string> vs;
     string2vector(s, vs, minLength, maxLength, sep);
@@ -176,7 +289,7 @@ void xmlutils::string2vector(std::string s, std::vector<bool>& v, int minLength,
         v.push_back(boost::lexical_cast<bool>(*it));
 }
 
-void xmlutils::string2vector(std::string s, std::vector<float>& v, int minLength, int maxLength, const char *sep)
+void xmlutils::string2vector(const std::string &s, std::vector<float>& v, int minLength, int maxLength, const char *sep)
 {
     std::vector<std::string> vs;
     string2vector(s, vs, minLength, maxLength, sep);
@@ -185,7 +298,7 @@ void xmlutils::string2vector(std::string s, std::vector<float>& v, int minLength
         v.push_back(boost::lexical_cast<float>(*it));
 }
 
-void xmlutils::string2vector(std::string s, std::vector<double>& v, int minLength, int maxLength, const char *sep)
+void xmlutils::string2vector(const std::string &s, std::vector<double>& v, int minLength, int maxLength, const char *sep)
 {
     std::vector<std::string> vs;
     string2vector(s, vs, minLength, maxLength, sep);
@@ -194,7 +307,7 @@ void xmlutils::string2vector(std::string s, std::vector<double>& v, int minLengt
         v.push_back(boost::lexical_cast<double>(*it));
 }
 
-void xmlutils::string2vector(std::string s, std::vector<int>& v, int minLength, int maxLength, const char *sep)
+void xmlutils::string2vector(const std::string &s, std::vector<int>& v, int minLength, int maxLength, const char *sep)
 {
     std::vector<std::string> vs;
     string2vector(s, vs, minLength, maxLength, sep);
@@ -203,234 +316,91 @@ void xmlutils::string2vector(std::string s, std::vector<int>& v, int minLength,
         v.push_back(boost::lexical_cast<int>(*it));
 }
 
-std::vector<std::string> xmlutils::getAttrStrV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<std::string> xmlutils::getAttrStrV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    std::vector<std::string> defaultValueV;
-    try
-    {
-        string2vector(defaultValue, defaultValueV, minLength, maxLength, sep);
-    }
-    catch(std::range_error &ex)
-    {
-        std::stringstream ss;
-        ss << "invalid default value for attribute '" << name << "': " << ex.what();
-        throw std::range_error(ss.str());
-    }
-
-    return getAttrStrV(e, name, defaultValueV, minLength, maxLength, sep);
+    return getAttrV<std::string>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<std::string> xmlutils::getAttrStrV(tinyxml2::XMLElement *e, std::string name, std::vector<std::string> defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<std::string> xmlutils::getAttrStrV(tinyxml2::XMLElement *e, const char *name, const std::vector<std::string> &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    if(hasAttr(e, name))
-    {
-        try
-        {
-            std::vector<std::string> ret;
-            string2vector(getAttrStr(e, name), ret, minLength, maxLength, sep);
-            return ret;
-        }
-        catch(std::range_error &ex)
-        {
-            std::stringstream ss;
-            ss << "attribute '" << name << "' " << ex.what();
-            throw std::range_error(ss.str());
-        }
-    }
-    else
-    {
-        return defaultValue;
-    }
+    return getAttrV<std::string>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<bool> xmlutils::getAttrBoolV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<bool> xmlutils::getAttrBoolV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    std::vector<bool> defaultValueV;
-    try
-    {
-        string2vector(defaultValue, defaultValueV, minLength, maxLength, sep);
-    }
-    catch(std::range_error &ex)
-    {
-        std::stringstream ss;
-        ss << "invalid default value for attribute '" << name << "': " << ex.what();
-        throw std::range_error(ss.str());
-    }
-
-    return getAttrBoolV(e, name, defaultValueV, minLength, maxLength, sep);
+    return getAttrV<bool>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<bool> xmlutils::getAttrBoolV(tinyxml2::XMLElement *e, std::string name, std::vector<bool> defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<bool> xmlutils::getAttrBoolV(tinyxml2::XMLElement *e, const char *name, const std::vector<bool> &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    if(hasAttr(e, name))
-    {
-        try
-        {
-            std::vector<bool> ret;
-            string2vector(getAttrStr(e, name), ret, minLength, maxLength, sep);
-            return ret;
-        }
-        catch(std::range_error &ex)
-        {
-            std::stringstream ss;
-            ss << "attribute '" << name << "' " << ex.what();
-            throw std::range_error(ss.str());
-        }
-    }
-    else
-    {
-        return defaultValue;
-    }
+    return getAttrV<bool>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<float> xmlutils::getAttrFloatV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<float> xmlutils::getAttrFloatV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    std::vector<float> defaultValueV;
-    try
-    {
-        string2vector(defaultValue, defaultValueV, minLength, maxLength, sep);
-    }
-    catch(std::range_error &ex)
-    {
-        std::stringstream ss;
-        ss << "invalid default value for attribute '" << name << "': " << ex.what();
-        throw std::range_error(ss.str());
-    }
-
-    return getAttrFloatV(e, name, defaultValueV, minLength, maxLength, sep);
+    return getAttrV<float>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<float> xmlutils::getAttrFloatV(tinyxml2::XMLElement *e, std::string name, std::vector<float> defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<float> xmlutils::getAttrFloatV(tinyxml2::XMLElement *e, const char *name, const std::vector<float> &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    if(hasAttr(e, name))
-    {
-        try
-        {
-            std::vector<float> ret;
-            string2vector(getAttrStr(e, name), ret, minLength, maxLength, sep);
-            return ret;
-        }
-        catch(std::range_error &ex)
-        {
-            std::stringstream ss;
-            ss << "attribute '" << name << "' " << ex.what();
-            throw std::range_error(ss.str());
-        }
-    }
-    else
-    {
-        return defaultValue;
-    }
+    return getAttrV<float>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<double> xmlutils::getAttrDoubleV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<double> xmlutils::getAttrDoubleV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    std::vector<double> defaultValueV;
-    try
-    {
-        string2vector(defaultValue, defaultValueV, minLength, maxLength, sep);
-    }
-    catch(std::range_error &ex)
-    {
-        std::stringstream ss;
-        ss << "invalid default value for attribute '" << name << "': " << ex.what();
-        throw std::range_error(ss.str());
-    }
-
-    return getAttrDoubleV(e, name, defaultValueV, minLength, maxLength, sep);
+    return getAttrV<double>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<double> xmlutils::getAttrDoubleV(tinyxml2::XMLElement *e, std::string name, std::vector<double> defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<double> xmlutils::getAttrDoubleV(tinyxml2::XMLElement *e, const char *name, const std::vector<double> &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    if(hasAttr(e, name))
-    {
-        try
-        {
-            std::vector<double> ret;
-            string2vector(getAttrStr(e, name), ret, minLength, maxLength, sep);
-            return ret;
-        }
-        catch(std::range_error &ex)
-        {
-            std::stringstream ss;
-            ss << "attribute '" << name << "' " << ex.what();
-            throw std::range_error(ss.str());
-        }
-    }
-    else
-    {
-        return defaultValue;
-    }
+    return getAttrV<double>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<int> xmlutils::getAttrIntV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<int> xmlutils::getAttrIntV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    std::vector<int> defaultValueV;
-    try
-    {
-        string2vector(defaultValue, defaultValueV, minLength, maxLength, sep);
-    }
-    catch(std::range_error &ex)
-    {
-        std::stringstream ss;
-        ss << "invalid default value for attribute '" << name << "': " << ex.what();
-        throw std::range_error(ss.str());
-    }
-
-    return getAttrIntV(e, name, defaultValueV, minLength, maxLength, sep);
+    return getAttrV<int>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-std::vector<int> xmlutils::getAttrIntV(tinyxml2::XMLElement *e, std::string name, std::vector<int> defaultValue, int minLength, int maxLength, const char *sep)
+std::vector<int> xmlutils::getAttrIntV(tinyxml2::XMLElement *e, const char *name, const std::vector<int> &defaultValue, int minLength, int maxLength, const char *sep)
 {
-    if(hasAttr(e, name))
-    {
-        try
-        {
-            std::vector<int> ret;
-            string2vector(getAttrStr(e, name), ret, minLength, maxLength, sep);
-            return ret;
-        }
-        catch(std::range_error &ex)
-        {
-            std::stringstream ss;
-            ss << "attribute '" << name << "' " << ex.what();
-            throw std::range_error(ss.str());
-        }
-    }
-    else
-    {
-        return defaultValue;
-    }
+    return getAttrV<int>(e, name, defaultValue, minLength, maxLength, sep);
 }
 
-namespace xmlutils { static std::vector<std::set<std::string> > knownAttributes; };
-
-void xmlutils::resetKnownAttributes()
+void xmlutils::resetKnownAttributes(tinyxml2::XMLElement *e)
 {
-    knownAttributes.push_back(std::set<std::string>());
+    std::size_t begin = attributeEntries.size();
+    attributeFrames.push_back(AttributeFrame{e, begin});
+    for(const tinyxml2::XMLAttribute *a = e->FirstAttribute(); a; a = a->Next())
+        attributeEntries.push_back(AttributeEntry{a->Name(), a->Value(), false});
+    std::sort(attributeEntries.begin() + begin, attributeEntries.end(), [](const AttributeEntry &x, const AttributeEntry &y) {return std::strcmp(x.name, y.name) < 0;});
 }
 
-void xmlutils::markKnownAttribute(std::string a)
+void xmlutils::discardKnownAttributes(tinyxml2::XMLElement *e)
 {
-    if(knownAttributes.size())
-        knownAttributes.back().insert(a);
+    for(size_t i = attributeFrames.size(); i > 0; i--)
+    {
+        if(attributeFrames[i - 1].e == e)
+        {
+            attributeEntries.resize(attributeFrames[i - 1].begin);
+            attributeFrames.resize(i - 1);
+            break;
+        }
+    }
 }
 
-#include <iostream>
-
 std::set<std::string> xmlutils::getUnknownAttributes(tinyxml2::XMLElement *e)
 {
-    if(knownAttributes.size() == 0)
-        return std::set<std::string>();
-    std::set<std::string> &knownAttributes1 = knownAttributes.back();
     std::set<std::string> ret;
-    for(const tinyxml2::XMLAttribute *a = e->FirstAttribute(); a; a = a->Next())
+    if(attributeFrames.empty() || attributeFrames.back().e != e)
+        return ret;
+    std::size_t begin = attributeFrames.back().begin;
+    for(std::size_t i = begin; i < attributeEntries.size(); i++)
     {
-        std::string attr(a->Name());
-        if(knownAttributes1.find(attr) == knownAttributes1.end())
-            ret.insert(attr);
+        if(!attributeEntries[i].known)
+            ret.insert(attributeEntries[i].name);
     }
-    knownAttributes.pop_back();
+    attributeEntries.resize(begin);
+    attributeFrames.pop_back();
     return ret;
 }
 
@@ -451,3 +421,42 @@ std::string xmlutils::elementToString(tinyxml2::XMLElement *element)
     return ss.str();
 }
 
+static const tinyxml2::XMLNode * nextNonComment(const tinyxml2::XMLNode *node)
+{
+    while(node && node->ToComment())
+        node = node->NextSibling();
+    return node;
+}
+
+bool xmlutils::equalElements(const tinyxml2::XMLElement *a, const tinyxml2::XMLElement *b)
+{
+    // (compares the name and the attributes)
+    if(!a->ShallowEqual(b)) return false;
+
+    const tinyxml2::XMLNode *x = nextNonComment(a->FirstChild());
+    const tinyxml2::XMLNode *y = nextNonComment(b->FirstChild());
+    while(x && y)
+    {
+        if(x->ToElement() && y->ToElement())
+        {
+            if(!equalElements(x->ToElement(), y->ToElement())) return false;
+        }
+        else if(x->ToElement() || y->ToElement() || !x->ShallowEqual(y))
+        {
+            return false;
+        }
+        x = nextNonComment(x->NextSibling());
+        y = nextNonComment(y->NextSibling());
+    }
+    return !x && !y;
+}
+
+void xmlutils::elementsById(tinyxml2::XMLElement *e, std::map<int, tinyxml2::XMLElement*> &elements)
+{
+    int id;
+    if(e->QueryIntAttribute("id", &id) == tinyxml2::XML_NO_ERROR)
+        elements[id] = e;
+    for(tinyxml2::XMLElement *c = e->FirstChildElement(); c; c = c->NextSiblingElement())
+        elementsById(c, elements);
+}
+
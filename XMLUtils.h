@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <map>
 #include <set>
 
 #include "tinyxml2.h"
@@ -17,59 +18,70 @@ namespace xmlutils
 
     std::string stripHyphens(const std::string &name);
 
-    bool hasAttr(tinyxml2::XMLElement *e, std::string name);
+    bool hasAttr(tinyxml2::XMLElement *e, const char *name);
 
-    bool getAttrBool(tinyxml2::XMLElement *e, std::string name, bool defaultValue);
+    bool getAttrBool(tinyxml2::XMLElement *e, const char *name, bool defaultValue);
 
-    int getAttrInt(tinyxml2::XMLElement *e, std::string name, int defaultValue);
+    int getAttrInt(tinyxml2::XMLElement *e, const char *name, int defaultValue);
 
-    float getAttrFloat(tinyxml2::XMLElement *e, std::string name, float defaultValue);
+    float getAttrFloat(tinyxml2::XMLElement *e, const char *name, float defaultValue);
 
-    double getAttrDouble(tinyxml2::XMLElement *e, std::string name, double defaultValue);
+    double getAttrDouble(tinyxml2::XMLElement *e, const char *name, double defaultValue);
 
-    std::string getAttrStr(tinyxml2::XMLElement *e, std::string name);
+    std::string getAttrStr(tinyxml2::XMLElement *e, const char *name);
 
-    std::string getAttrStr(tinyxml2::XMLElement *e, std::string name, std::string defaultValue);
+    std::string getAttrStr(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue);
 
-    void string2vector(std::string s, std::vector<std::string>& v, int minLength, int maxLength, const char *sep);
+    void string2vector(const std::string &s, std::vector<std::string>& v, int minLength, int maxLength, const char *sep);
 
-    void string2vector(std::string s, std::vector<bool>& v, int minLength, int maxLength, const char *sep);
+    void string2vector(const std::string &s, std::vector<bool>& v, int minLength, int maxLength, const char *sep);
 
-    void string2vector(std::string s, std::vector<float>& v, int minLength, int maxLength, const char *sep);
+    void string2vector(const std::string &s, std::vector<float>& v, int minLength, int maxLength, const char *sep);
 
-    void string2vector(std::string s, std::vector<double>& v, int minLength, int maxLength, const char *sep);
+    void string2vector(const std::string &s, std::vector<double>& v, int minLength, int maxLength, const char *sep);
 
-    void string2vector(std::string s, std::vector<int>& v, int minLength, int maxLength, const char *sep);
+    void string2vector(const std::string &s, std::vector<int>& v, int minLength, int maxLength, const char *sep);
 
-    std::vector<std::string> getAttrStrV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<std::string> getAttrStrV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<std::string> getAttrStrV(tinyxml2::XMLElement *e, std::string name, std::vector<std::string> defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<std::string> getAttrStrV(tinyxml2::XMLElement *e, const char *name, const std::vector<std::string> &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<bool> getAttrBoolV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<bool> getAttrBoolV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<bool> getAttrBoolV(tinyxml2::XMLElement *e, std::string name, std::vector<bool> defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<bool> getAttrBoolV(tinyxml2::XMLElement *e, const char *name, const std::vector<bool> &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<float> getAttrFloatV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<float> getAttrFloatV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<float> getAttrFloatV(tinyxml2::XMLElement *e, std::string name, std::vector<float> defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<float> getAttrFloatV(tinyxml2::XMLElement *e, const char *name, const std::vector<float> &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<double> getAttrDoubleV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<double> getAttrDoubleV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<double> getAttrDoubleV(tinyxml2::XMLElement *e, std::string name, std::vector<double> defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<double> getAttrDoubleV(tinyxml2::XMLElement *e, const char *name, const std::vector<double> &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<int> getAttrIntV(tinyxml2::XMLElement *e, std::string name, std::string defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<int> getAttrIntV(tinyxml2::XMLElement *e, const char *name, const std::string &defaultValue, int minLength, int maxLength, const char *sep);
 
-    std::vector<int> getAttrIntV(tinyxml2::XMLElement *e, std::string name, std::vector<int> defaultValue, int minLength, int maxLength, const char *sep);
+    std::vector<int> getAttrIntV(tinyxml2::XMLElement *e, const char *name, const std::vector<int> &defaultValue, int minLength, int maxLength, const char *sep);
 
-    void resetKnownAttributes();
+    // attributes read by the getters above are marked as known in the
+    // elements passed to resetKnownAttributes(), until the matching
+    // getUnknownAttributes() or discardKnownAttributes():
+    void resetKnownAttributes(tinyxml2::XMLElement *e);
 
-    void markKnownAttribute(std::string a);
+    void discardKnownAttributes(tinyxml2::XMLElement *e);
 
     std::set<std::string> getUnknownAttributes(tinyxml2::XMLElement *e);
 
     void reportUnknownAttributes(const std::string &widget, tinyxml2::XMLElement *e);
 
     std::string elementToString(tinyxml2::XMLElement *element);
+
+    // true if the two elements have the same name, attributes, text and
+    // children (comments are ignored):
+    bool equalElements(const tinyxml2::XMLElement *a, const tinyxml2::XMLElement *b);
+
+    // adds to elements the given element and its descendants which have an
+    // (integer) id attribute:
+    void elementsById(tinyxml2::XMLElement *e, std::map<int, tinyxml2::XMLElement*> &elements);
 };
 
 #endif // XMLUTILS_H_INCLUDED
@@ -0,0 +1,388 @@
+// a benchmark of the plugin, outside of CoppeliaSim: the plugin is loaded
+// as usual (simStart, simMessage, simEnd), but against a stand-in for the
+// CoppeliaSim library (see simStub.cpp), on the Qt offscreen platform; the
+// main thread is the UI thread, and a second thread plays the role of the
+// simulation thread, calling the functions of the plugin as the Lua API
+// would (see c.cpp); the results are written in JSON:
+//
+//     simUI-benchmark [--iterations N] [output.json]
+//
+// (times are in microseconds)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <QApplication>
+#include <QDir>
+#include <QPushButton>
+#include <QThread>
+
+#include "simConst.h"
+#include "stubs.h"
+#include "SIM.h"
+#include "widgets/Widget.h"
+
+extern "C" unsigned char simStart(void *reservedPointer, int reservedInt);
+extern "C" void simEnd();
+extern "C" void * simMessage(int message, int *auxiliaryData, void *customData, int *replyData);
+
+typedef std::chrono::steady_clock Clock;
+
+static double elapsed(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+struct Result
+{
+    std::string name;
+    // duration of each operation:
+    std::vector<double> samples;
+    // duration of the whole run (which may include waiting for the UI
+    // thread to execute the commands of an async UI):
+    double total;
+};
+
+// the script which owns the UIs (see simGetScriptProperty in simStub.cpp):
+static const int scriptID = 1;
+
+static std::string createUI(const std::string &xml)
+{
+    create_in in;
+    in._.scriptID = scriptID;
+    in.xml = xml;
+    create_out out;
+    create(nullptr, "", &in, &out);
+    return out.uiHandle;
+}
+
+static void destroyUI(const std::string &handle)
+{
+    destroy_in in;
+    in.handle = handle;
+    destroy_out out;
+    destroy(nullptr, "", &in, &out);
+}
+
+// waits until the UI thread has executed all the commands:
+static void flush()
+{
+    emit SIM::getInstance()->flushCommands();
+}
+
+class Benchmark : public QThread
+{
+public:
+    Benchmark(int iterations_)
+        : iterations(iterations_)
+    {
+    }
+
+    std::vector<Result> results;
+    std::string error;
+
+protected:
+    void run()
+    {
+        int auxData[4] = {0, 0, 0, 0};
+        simMessage(sim_message_eventcallback_instancepass, auxData, NULL, NULL);
+        try
+        {
+            createDestroy();
+            setters(false);
+            setters(true);
+            plotAppend();
+            imageUpdate();
+            tableFill();
+            eventDispatch();
+        }
+        catch(std::exception &ex)
+        {
+            error = ex.what();
+        }
+        simMessage(sim_message_eventcallback_lastinstancepass, auxData, NULL, NULL);
+        QMetaObject::invokeMethod(qApp, "quit", Qt::QueuedConnection);
+    }
+
+private:
+    int iterations;
+
+    template<typename F>
+    void measure(const std::string &name, int n, F f)
+    {
+        Result result{name, {}, 0};
+        Clock::time_point start = Clock::now();
+        for(int i = 0; i < n; i++)
+        {
+            Clock::time_point t = Clock::now();
+            f(i);
+            result.samples.push_back(elapsed(t));
+        }
+        flush();
+        result.total = elapsed(start);
+        results.push_back(result);
+    }
+
+    void createDestroy()
+    {
+        std::string xml =
+            "<ui title=\"benchmark\" layout=\"form\">"
+            "<label text=\"a\" /><edit value=\"a\" />"
+            "<label text=\"b\" /><hslider minimum=\"0\" maximum=\"100\" />"
+            "<label text=\"c\" /><spinbox minimum=\"0\" maximum=\"100\" />"
+            "<label text=\"d\" /><checkbox text=\"d\" />"
+            "<label text=\"e\" /><combobox><item>1</item><item>2</item></combobox>"
+            "<label text=\"f\" /><button text=\"f\" />"
+            "<label text=\"g\" /><progressbar value=\"50\" />"
+            "<label text=\"h\" /><group layout=\"hbox\"><radiobutton text=\"h1\" /><radiobutton text=\"h2\" /></group>"
+            "</ui>";
+        int n = std::max(1, iterations / 10);
+        measure("create-destroy", n, [&](int i) {
+            destroyUI(createUI(xml));
+        });
+    }
+
+    void setters(bool async)
+    {
+        std::string handle = createUI(std::string("<ui async=\"") + (async ? "true" : "false") + "\"><hslider id=\"1\" minimum=\"0\" maximum=\"1000\" /></ui>");
+        measure(async ? "setter-async" : "setter-sync", iterations, [&](int i) {
+            setSliderValue_in in;
+            in.handle = handle;
+            in.id = 1;
+            in.value = i % 1000;
+            in.suppressEvents = true;
+            setSliderValue_out out;
+            setSliderValue(nullptr, "", &in, &out);
+        });
+        destroyUI(handle);
+    }
+
+    void plotAppend()
+    {
+        std::string handle = createUI("<ui><plot id=\"1\" /></ui>");
+
+        addCurve_in curveIn;
+        curveIn.handle = handle;
+        curveIn.id = 1;
+        curveIn.type = sim_ui_curve_type_time;
+        curveIn.name = "curve";
+        curveIn.color = {255, 0, 0};
+        curveIn.style = sim_ui_curve_style_line;
+        addCurve_out curveOut;
+        addCurve(nullptr, "", &curveIn, &curveOut);
+
+        // 10 points per call, and a replot every 10 calls:
+        measure("plot-append", iterations, [&](int i) {
+            addCurveTimePoints_in in;
+            in.handle = handle;
+            in.id = 1;
+            in.name = "curve";
+            for(int j = 0; j < 10; j++)
+            {
+                in.x.push_back(i * 10 + j);
+                in.y.push_back((i * 10 + j) % 100);
+            }
+            addCurveTimePoints_out out;
+            addCurveTimePoints(nullptr, "", &in, &out);
+
+            if(i % 10 == 9)
+            {
+                replot_in replotIn;
+                replotIn.handle = handle;
+                replotIn.id = 1;
+                replot_out replotOut;
+                replot(nullptr, "", &replotIn, &replotOut);
+            }
+        });
+        destroyUI(handle);
+    }
+
+    void imageUpdate()
+    {
+        const int width = 320, height = 240;
+        std::string handle = createUI("<ui><image id=\"1\" width=\"320\" height=\"240\" /></ui>");
+        std::string data(width * height * 3, '\0');
+        measure("image-update", iterations, [&](int i) {
+            std::fill(data.begin(), data.end(), char(i));
+            setImageData_in in;
+            in.handle = handle;
+            in.id = 1;
+            in.data = data;
+            in.width = width;
+            in.height = height;
+            setImageData_out out;
+            setImageData(nullptr, "", &in, &out);
+        });
+        destroyUI(handle);
+    }
+
+    void tableFill()
+    {
+        const int rows = 100, columns = 10;
+        std::string handle = createUI("<ui><table id=\"1\" /></ui>");
+        int n = std::max(1, iterations / 100);
+        // one sample per table (rows * columns items):
+        measure("table-fill", n, [&](int i) {
+            setRowCount_in rowsIn;
+            rowsIn.handle = handle;
+            rowsIn.id = 1;
+            rowsIn.count = rows;
+            setRowCount_out rowsOut;
+            setRowCount(nullptr, "", &rowsIn, &rowsOut);
+
+            setColumnCount_in columnsIn;
+            columnsIn.handle = handle;
+            columnsIn.id = 1;
+            columnsIn.count = columns;
+            setColumnCount_out columnsOut;
+            setColumnCount(nullptr, "", &columnsIn, &columnsOut);
+
+            for(int row = 0; row < rows; row++)
+            {
+                for(int column = 0; column < columns; column++)
+                {
+                    setItem_in in;
+                    in.handle = handle;
+                    in.id = 1;
+                    in.row = row;
+                    in.column = column;
+                    in.text = std::to_string(i * rows * columns + row * columns + column);
+                    setItem_out out;
+                    setItem(nullptr, "", &in, &out);
+                }
+            }
+        });
+        destroyUI(handle);
+    }
+
+    // time from a click in the UI thread to the event being received by the
+    // simulation thread (with poll-events, clicks are recorded without an
+    // on-click handler, so no script callback is involved):
+    void eventDispatch()
+    {
+        std::string handle = createUI("<ui poll-events=\"true\"><button id=\"1\" text=\"benchmark\" /></ui>");
+
+        // (the UI thread is idle, waiting for its next event)
+        QPushButton *button = NULL;
+        for(QWidget *qwidget : QApplication::allWidgets())
+        {
+            Widget *widget = Widget::byQWidget(qwidget);
+            if(widget && widget->getId() == 1 && qobject_cast<QPushButton*>(qwidget))
+                button = static_cast<QPushButton*>(qwidget);
+        }
+        if(!button)
+            throw std::runtime_error("button not found");
+
+        measure("event-dispatch", iterations, [&](int i) {
+            QMetaObject::invokeMethod(button, "click", Qt::QueuedConnection);
+            pollEvents_in in;
+            in.handle = handle;
+            pollEvents_out out;
+            while(out.events.empty())
+            {
+                // delivers the signals of the UI thread to SIM:
+                QCoreApplication::processEvents();
+                pollEvents(nullptr, "", &in, &out);
+            }
+        });
+        destroyUI(handle);
+    }
+};
+
+static double percentile(const std::vector<double> &sorted, double p)
+{
+    if(sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, std::size_t(p * (sorted.size() - 1) + 0.5))];
+}
+
+static void writeResults(std::ostream &f, const std::vector<Result> &results)
+{
+    f << std::fixed << std::setprecision(3);
+    f << "{" << std::endl;
+    f << "\"qt_version\":\"" << qVersion() << "\"," << std::endl;
+    f << "\"platform\":\"" << QGuiApplication::platformName().toStdString() << "\"," << std::endl;
+    f << "\"benchmarks\":[";
+    for(std::size_t i = 0; i < results.size(); i++)
+    {
+        const Result &r = results[i];
+        std::vector<double> s(r.samples);
+        std::sort(s.begin(), s.end());
+        double sum = 0;
+        for(double x : s) sum += x;
+        f << (i ? "," : "") << std::endl;
+        f << "{\"name\":\"" << r.name << "\"";
+        f << ",\"iterations\":" << s.size();
+        f << ",\"total\":" << r.total;
+        f << ",\"mean\":" << (s.empty() ? 0 : sum / s.size());
+        f << ",\"min\":" << (s.empty() ? 0 : s.front());
+        f << ",\"p50\":" << percentile(s, 0.5);
+        f << ",\"p95\":" << percentile(s, 0.95);
+        f << ",\"p99\":" << percentile(s, 0.99);
+        f << ",\"max\":" << (s.empty() ? 0 : s.back());
+        f << ",\"ops_per_second\":" << (r.total > 0 ? s.size() * 1e6 / r.total : 0);
+        f << "}";
+    }
+    f << std::endl << "]}" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 1000;
+    std::string output;
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg(argv[i]);
+        if(arg == "--iterations" && i + 1 < argc)
+            iterations = std::max(1, std::atoi(argv[++i]));
+        else
+            output = arg;
+    }
+
+    if(qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication app(argc, argv);
+
+    // the stand-in for the CoppeliaSim library is next to the executable:
+    QDir::setCurrent(QCoreApplication::applicationDirPath());
+    if(!simStart(NULL, 0))
+    {
+        std::cerr << "simUI-benchmark: simStart failed" << std::endl;
+        return 1;
+    }
+
+    Benchmark benchmark(iterations);
+    benchmark.start();
+    app.exec();
+    benchmark.wait();
+
+    simEnd();
+
+    if(!benchmark.error.empty())
+    {
+        std::cerr << "simUI-benchmark: " << benchmark.error << std::endl;
+        return 1;
+    }
+
+    if(output.empty())
+    {
+        writeResults(std::cout, benchmark.results);
+    }
+    else
+    {
+        std::ofstream f(output);
+        if(!f)
+        {
+            std::cerr << "simUI-benchmark: cannot open file " << output << std::endl;
+            return 1;
+        }
+        writeResults(f, benchmark.results);
+    }
+    return 0;
+}
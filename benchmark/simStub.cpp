@@ -0,0 +1,109 @@
+#include "simStub.h"
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "simConst.h"
+#include "simTypes.h"
+
+// messages with a higher verbosity are not printed (see simAddLog):
+static int verbosity = std::getenv("SIMUI_BENCHMARK_VERBOSITY") ? std::atoi(std::getenv("SIMUI_BENCHMARK_VERBOSITY")) : sim_verbosity_warnings;
+
+void simStubMissing(const char *function)
+{
+    std::fprintf(stderr, "simUI-benchmark: %s is not implemented by the CoppeliaSim stand-in (see benchmark/simStub.cpp)\n", function);
+    std::abort();
+}
+
+SIMSTUB_EXPORT simInt simAddLog(const simChar *pluginName, simInt verbosityLevel, const simChar *logMsg)
+{
+    // (the higher bits are flags, e.g. sim_verbosity_undecorated)
+    if((verbosityLevel & 0x0fff) <= verbosity)
+        std::fprintf(stderr, "[%s] %s\n", pluginName ? pluginName : "", logMsg);
+    return 1;
+}
+
+SIMSTUB_EXPORT simInt simGetModuleInfo(const simChar *moduleName, simInt infoType, simChar **stringInfo, simInt *intInfo)
+{
+    if(infoType == sim_moduleinfo_verbosity || infoType == sim_moduleinfo_statusbarverbosity)
+    {
+        *intInfo = verbosity;
+        return 1;
+    }
+    return -1;
+}
+
+SIMSTUB_EXPORT simInt simSetModuleInfo(const simChar *moduleName, simInt infoType, const simChar *stringInfo, simInt intInfo)
+{
+    return 1;
+}
+
+SIMSTUB_EXPORT simInt simGetInt32Parameter(simInt parameter, simInt *intState)
+{
+    switch(parameter)
+    {
+    case sim_intparam_program_version:
+        *intState = 40100;
+        break;
+    case sim_intparam_scene_unique_id:
+        // there is only one scene:
+        *intState = 1;
+        break;
+    case sim_intparam_verbosity:
+        *intState = verbosity;
+        break;
+    default:
+        *intState = 0;
+        break;
+    }
+    return 1;
+}
+
+SIMSTUB_EXPORT simInt simGetBooleanParameter(simInt parameter)
+{
+    // in particular, not headless:
+    return 0;
+}
+
+SIMSTUB_EXPORT simInt simGetFloatParameter(simInt parameter, simFloat *floatState)
+{
+    *floatState = 1;
+    return 1;
+}
+
+SIMSTUB_EXPORT simVoid * simGetMainWindow(simInt type)
+{
+    // the windows of the plugin are top-level windows:
+    return NULL;
+}
+
+SIMSTUB_EXPORT simInt simGetScriptProperty(simInt scriptHandle, simInt *scriptProperty, simInt *associatedObjectHandle)
+{
+    *scriptProperty = sim_scripttype_childscript;
+    *associatedObjectHandle = -1;
+    return 1;
+}
+
+SIMSTUB_EXPORT simChar * simCreateBuffer(simInt size)
+{
+    return static_cast<simChar *>(std::malloc(size));
+}
+
+SIMSTUB_EXPORT simInt simReleaseBuffer(const simChar *buffer)
+{
+    std::free(const_cast<simChar *>(buffer));
+    return 1;
+}
+
+// the functions of the plugin are called directly by the benchmark, not from
+// Lua (see main.cpp):
+
+SIMSTUB_EXPORT simInt simRegisterScriptCallbackFunction(const simChar *funcNameAtPluginName, const simChar *callTips, simVoid (*callBack)(struct SScriptCallBack *cb))
+{
+    return 1;
+}
+
+SIMSTUB_EXPORT simInt simRegisterScriptVariable(const simChar *varName, const simChar *varValue, simInt stackID)
+{
+    return 1;
+}
@@ -0,0 +1,19 @@
+#ifndef SIMSTUB_H_INCLUDED
+#define SIMSTUB_H_INCLUDED
+
+/**
+ * a stand-in for the CoppeliaSim library, used by the benchmark (see main.cpp):
+ * it implements the few functions that the plugin calls when running outside
+ * of a scene (see simStub.cpp); all the other functions of the library are
+ * generated from simLib.h (see CMakeLists.txt) as weak symbols, which abort
+ * the benchmark if they are called
+ */
+
+#define SIMSTUB_EXPORT extern "C" __attribute__((visibility("default")))
+#define SIMSTUB_WEAK __attribute__((weak))
+
+void simStubMissing(const char *function);
+
+#define SIMSTUB_MISSING(f) SIMSTUB_EXPORT SIMSTUB_WEAK void f() {simStubMissing(#f);}
+
+#endif // SIMSTUB_H_INCLUDED
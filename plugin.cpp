@@ -3,6 +3,7 @@
 #include <sstream>
 #include <vector>
 #include <map>
+#include <set>
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/foreach.hpp>
@@ -32,7 +33,11 @@
 #include "stubs.h"
 #include "Proxy.h"
 #include "SIM.h"
+#include "Stats.h"
+#include "TemplateCache.h"
+#include "Trace.h"
 #include "UI.h"
+#include "XMLUtils.h"
 #include "widgets/all.h"
 
 #ifdef ENABLE_SIGNAL_SPY
@@ -83,6 +88,7 @@ public:
 
     void onLastInstancePass()
     {
+        TemplateCache::clear();
         SIM::destroyInstance();
     }
 
@@ -145,39 +151,30 @@ public:
         sim::addLog(sim_verbosity_debug, "[leave]");
     }
 
-    void create(create_in *in, create_out *out)
+    Proxy * newProxy(int scriptID, const std::string &xml)
     {
-        ASSERT_THREAD(!UI);
-        sim::addLog(sim_verbosity_debug, "[enter]");
-        tinyxml2::XMLDocument xmldoc;
-        tinyxml2::XMLError error = xmldoc.Parse(in->xml.c_str(), in->xml.size());
-
-        if(error != tinyxml2::XML_NO_ERROR)
-            throw std::runtime_error("XML parse error");
-
-        tinyxml2::XMLElement *rootElement = xmldoc.FirstChildElement();
         std::map<int, Widget*> widgets;
-        Window *window = new Window;
-        try
-        {
-            window->parse(widgets, rootElement);
-        }
-        catch(std::exception& ex)
-        {
-            delete window;
-            throw;
-        }
+        Window *window = TemplateCache::instantiate(xml, widgets);
 
         // determine wether the Proxy object should be destroyed at simulation end
         int scriptType;
         int objectHandle;
-        simGetScriptProperty(in->_.scriptID, &scriptType, &objectHandle);
+        simGetScriptProperty(scriptID, &scriptType, &objectHandle);
         int sceneID = sim::getInt32Parameter(sim_intparam_scene_unique_id);
         sim::addLog(sim_verbosity_debug, "Creating a new Proxy object...");
-        Proxy *proxy = new Proxy(sceneID, in->_.scriptID, scriptType, window, widgets);
-        proxy->handle = handles.add(proxy, in->_.scriptID);
+        Proxy *proxy = new Proxy(sceneID, scriptID, scriptType, window, widgets);
+        proxy->handle = handles.add(proxy, scriptID);
+        proxy->xml = xml;
+        sim::addLog(sim_verbosity_debug, "Proxy %s created in scene %d", proxy->handle, sceneID);
+        return proxy;
+    }
+
+    void create(create_in *in, create_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        sim::addLog(sim_verbosity_debug, "[enter]");
+        Proxy *proxy = newProxy(in->_.scriptID, in->xml);
         out->uiHandle = proxy->handle;
-        sim::addLog(sim_verbosity_debug, "Proxy %s created in scene %d", out->uiHandle, sceneID);
 
         sim::addLog(sim_verbosity_debug, "call SIM::create() (will emit the create(Proxy*) signal)...");
         SIM::getInstance()->create(proxy); // connected to UI, which
@@ -185,6 +182,47 @@ public:
         sim::addLog(sim_verbosity_debug, "[leave]");
     }
 
+    void createAsync(createAsync_in *in, createAsync_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        sim::addLog(sim_verbosity_debug, "[enter]");
+        Proxy *proxy = newProxy(in->_.scriptID, in->xml);
+        proxy->onReady = in->onReady;
+        out->uiHandle = proxy->handle;
+
+        SIM::getInstance()->createAsync(proxy);
+        sim::addLog(sim_verbosity_debug, "[leave]");
+    }
+
+    void update(update_in *in, update_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        Proxy *proxy = handles.get(in->handle);
+
+        std::map<int, Widget*> widgets;
+        Window *window = TemplateCache::instantiate(in->xml, widgets);
+
+        // the widgets (with an explicit id) whose XML element has not changed:
+        std::set<int> unchanged;
+        tinyxml2::XMLDocument oldDoc, newDoc;
+        if(oldDoc.Parse(proxy->xml.c_str(), proxy->xml.size()) == tinyxml2::XML_NO_ERROR
+                && newDoc.Parse(in->xml.c_str(), in->xml.size()) == tinyxml2::XML_NO_ERROR)
+        {
+            std::map<int, tinyxml2::XMLElement*> oldElements, newElements;
+            xmlutils::elementsById(oldDoc.RootElement(), oldElements);
+            xmlutils::elementsById(newDoc.RootElement(), newElements);
+            for(const auto &x : newElements)
+            {
+                auto it = oldElements.find(x.first);
+                if(it != oldElements.end() && xmlutils::equalElements(it->second, x.second))
+                    unchanged.insert(x.first);
+            }
+        }
+        proxy->xml = in->xml;
+
+        SIM::getInstance()->updateStructure(proxy, window, widgets, unchanged);
+    }
+
     void destroy(destroy_in *in, destroy_out *out)
     {
         ASSERT_THREAD(!UI);
@@ -223,27 +261,11 @@ public:
         return twidget;
     }
 
-    template<typename T>
-    T* getQWidget(const std::string &handle, int id, const char *widget_type_name)
-    {
-        Widget *widget = getWidget<Widget>(handle, id, widget_type_name);
-
-        T *qwidget = dynamic_cast<T*>(widget->getQWidget());
-        if(!qwidget)
-        {
-            std::stringstream ss;
-            ss << "invalid widget type. expected " << widget_type_name << " (in function getQWidget())";
-            throw std::runtime_error(ss.str());
-        }
-
-        return qwidget;
-    }
-
     void setStyleSheet(setStyleSheet_in *in, setStyleSheet_out *out)
     {
         ASSERT_THREAD(!UI);
         Widget *widget = getWidget(in->handle, in->id);
-        SIM::getInstance()->setStyleSheet(widget, in->styleSheet);
+        SIM::getInstance()->update(widget, Property::StyleSheet, UI_SLOT(onSetStyleSheet), in->styleSheet);
     }
 
     void setButtonText(setButtonText_in *in, setButtonText_out *out)
@@ -251,7 +273,7 @@ public:
 #if WIDGET_BUTTON
         ASSERT_THREAD(!UI);
         Button *button = getWidget<Button>(in->handle, in->id, "button");
-        SIM::getInstance()->setButtonText(button, in->text);
+        SIM::getInstance()->update(button, Property::Text, UI_SLOT(onSetButtonText), in->text);
 #endif
     }
 
@@ -260,13 +282,14 @@ public:
 #if WIDGET_BUTTON
         ASSERT_THREAD(!UI);
         Button *button = getWidget<Button>(in->handle, in->id, "button");
-        SIM::getInstance()->setButtonPressed(button, in->pressed);
+        SIM::getInstance()->update(button, Property::Value, UI_SLOT(onSetButtonPressed), in->pressed);
 #endif
     }
 
     void getSliderValue(getSliderValue_in *in, getSliderValue_out *out)
     {
 #if WIDGET_HSLIDER || WIDGET_VSLIDER
+        ASSERT_THREAD(!UI);
         Slider *slider = getWidget<Slider>(in->handle, in->id, "slider");
         out->value = slider->getValue();
 #endif
@@ -277,13 +300,15 @@ public:
 #if WIDGET_HSLIDER || WIDGET_VSLIDER
         ASSERT_THREAD(!UI);
         Slider *slider = getWidget<Slider>(in->handle, in->id, "slider");
-        SIM::getInstance()->setSliderValue(slider, in->value, in->suppressEvents);
+        slider->mirrorValue(in->value);
+        SIM::getInstance()->update(slider, Property::Value, UI_SLOT(onSetSliderValue), in->value, in->suppressEvents);
 #endif
     }
 
     void getEditValue(getEditValue_in *in, getEditValue_out *out)
     {
 #if WIDGET_EDIT
+        ASSERT_THREAD(!UI);
         Edit *edit = getWidget<Edit>(in->handle, in->id, "edit");
         out->value = edit->getValue();
 #endif
@@ -294,13 +319,15 @@ public:
 #if WIDGET_EDIT
         ASSERT_THREAD(!UI);
         Edit *edit = getWidget<Edit>(in->handle, in->id, "edit");
-        SIM::getInstance()->setEditValue(edit, in->value, in->suppressEvents);
+        edit->mirrorValue(in->value);
+        SIM::getInstance()->update(edit, Property::Value, UI_SLOT(onSetEditValue), in->value, in->suppressEvents);
 #endif
     }
 
     void getSpinboxValue(getSpinboxValue_in *in, getSpinboxValue_out *out)
     {
 #if WIDGET_SPINBOX
+        ASSERT_THREAD(!UI);
         Spinbox *spinbox = getWidget<Spinbox>(in->handle, in->id, "spinbox");
         out->value = spinbox->getValue();
 #endif
@@ -311,13 +338,15 @@ public:
 #if WIDGET_SPINBOX
         ASSERT_THREAD(!UI);
         Spinbox *spinbox = getWidget<Spinbox>(in->handle, in->id, "spinbox");
-        SIM::getInstance()->setSpinboxValue(spinbox, in->value, in->suppressEvents);
+        spinbox->mirrorValue(in->value);
+        SIM::getInstance()->update(spinbox, Property::Value, UI_SLOT(onSetSpinboxValue), in->value, in->suppressEvents);
 #endif
     }
 
     void getCheckboxValue(getCheckboxValue_in *in, getCheckboxValue_out *out)
     {
 #if WIDGET_CHECKBOX
+        ASSERT_THREAD(!UI);
         Checkbox *checkbox = getWidget<Checkbox>(in->handle, in->id, "checkbox");
         out->value = checkbox->convertValueToInt(checkbox->getValue());
 #endif
@@ -329,13 +358,15 @@ public:
         ASSERT_THREAD(!UI);
         Checkbox *checkbox = getWidget<Checkbox>(in->handle, in->id, "checkbox");
         Qt::CheckState value = checkbox->convertValueFromInt(in->value);
-        SIM::getInstance()->setCheckboxValue(checkbox, value, in->suppressEvents);
+        checkbox->mirrorValue(value);
+        SIM::getInstance()->update(checkbox, Property::Value, UI_SLOT(onSetCheckboxValue), value, in->suppressEvents);
 #endif
     }
 
     void getRadiobuttonValue(getRadiobuttonValue_in *in, getRadiobuttonValue_out *out)
     {
 #if WIDGET_RADIOBUTTON
+        ASSERT_THREAD(!UI);
         Radiobutton *radiobutton = getWidget<Radiobutton>(in->handle, in->id, "radiobutton");
         out->value = radiobutton->convertValueToInt(radiobutton->getValue());
 #endif
@@ -347,13 +378,15 @@ public:
         ASSERT_THREAD(!UI);
         Radiobutton *radiobutton = getWidget<Radiobutton>(in->handle, in->id, "radiobutton");
         bool value = radiobutton->convertValueFromInt(in->value);
-        SIM::getInstance()->setRadiobuttonValue(radiobutton, value, in->suppressEvents);
+        radiobutton->mirrorValue(value);
+        SIM::getInstance()->call(radiobutton, UI_SLOT(onSetRadiobuttonValue), value, in->suppressEvents);
 #endif
     }
 
     void getLabelText(getLabelText_in *in, getLabelText_out *out)
     {
 #if WIDGET_LABEL
+        ASSERT_THREAD(!UI);
         Label *label = getWidget<Label>(in->handle, in->id, "label");
         out->text = label->getText();
 #endif
@@ -364,7 +397,8 @@ public:
 #if WIDGET_LABEL
         ASSERT_THREAD(!UI);
         Label *label = getWidget<Label>(in->handle, in->id, "label");
-        SIM::getInstance()->setLabelText(label, in->text, in->suppressEvents);
+        label->mirrorText(in->text);
+        SIM::getInstance()->update(label, Property::Text, UI_SLOT(onSetLabelText), in->text, in->suppressEvents);
 #endif
     }
 
@@ -373,7 +407,8 @@ public:
 #if WIDGET_COMBOBOX
         ASSERT_THREAD(!UI);
         Combobox *combobox = getWidget<Combobox>(in->handle, in->id, "combobox");
-        SIM::getInstance()->insertComboboxItem(combobox, in->index, in->text, in->suppressEvents);
+        combobox->mirrorInsertItem(in->index, in->text);
+        SIM::getInstance()->call(combobox, UI_SLOT(onInsertComboboxItem), in->index, in->text, in->suppressEvents);
 #endif
     }
 
@@ -382,13 +417,15 @@ public:
 #if WIDGET_COMBOBOX
         ASSERT_THREAD(!UI);
         Combobox *combobox = getWidget<Combobox>(in->handle, in->id, "combobox");
-        SIM::getInstance()->removeComboboxItem(combobox, in->index, in->suppressEvents);
+        combobox->mirrorRemoveItem(in->index);
+        SIM::getInstance()->call(combobox, UI_SLOT(onRemoveComboboxItem), in->index, in->suppressEvents);
 #endif
     }
 
     void getComboboxItemCount(getComboboxItemCount_in *in, getComboboxItemCount_out *out)
     {
 #if WIDGET_COMBOBOX
+        ASSERT_THREAD(!UI);
         Combobox *combobox = getWidget<Combobox>(in->handle, in->id, "combobox");
         out->count = combobox->count();
 #endif
@@ -397,6 +434,7 @@ public:
     void getComboboxItemText(getComboboxItemText_in *in, getComboboxItemText_out *out)
     {
 #if WIDGET_COMBOBOX
+        ASSERT_THREAD(!UI);
         Combobox *combobox = getWidget<Combobox>(in->handle, in->id, "combobox");
         out->text = combobox->itemText(in->index);
 #endif
@@ -405,6 +443,7 @@ public:
     void getComboboxItems(getComboboxItems_in *in, getComboboxItems_out *out)
     {
 #if WIDGET_COMBOBOX
+        ASSERT_THREAD(!UI);
         Combobox *combobox = getWidget<Combobox>(in->handle, in->id, "combobox");
         out->items = combobox->getItems();
 #endif
@@ -415,7 +454,8 @@ public:
 #if WIDGET_COMBOBOX
         ASSERT_THREAD(!UI);
         Combobox *combobox = getWidget<Combobox>(in->handle, in->id, "combobox");
-        SIM::getInstance()->setComboboxItems(combobox, in->items, in->index, in->suppressEvents);
+        combobox->mirrorItems(in->items, in->index);
+        SIM::getInstance()->call(combobox, UI_SLOT(onSetComboboxItems), makePayload(std::move(in->items)), in->index, in->suppressEvents);
 #endif
     }
 
@@ -424,7 +464,8 @@ public:
 #if WIDGET_COMBOBOX
         ASSERT_THREAD(!UI);
         Combobox *combobox = getWidget<Combobox>(in->handle, in->id, "combobox");
-        SIM::getInstance()->setComboboxSelectedIndex(combobox, in->index, in->suppressEvents);
+        combobox->mirrorSelectedIndex(in->index);
+        SIM::getInstance()->update(combobox, Property::CurrentIndex, UI_SLOT(onSetComboboxSelectedIndex), in->index, in->suppressEvents);
 #endif
     }
 
@@ -441,28 +482,33 @@ public:
     {
         ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
-        SIM::getInstance()->hideWindow(proxy->getWidget());
+        proxy->getWidget()->mirrorVisibility(false);
+        SIM::getInstance()->update(proxy->getWidget(), Property::Visibility, UI_SLOT(onHideWindow));
     }
 
     void show(show_in *in, show_out *out)
     {
         ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
-        SIM::getInstance()->showWindow(proxy->getWidget());
+        proxy->getWidget()->mirrorVisibility(true);
+        SIM::getInstance()->update(proxy->getWidget(), Property::Visibility, UI_SLOT(onShowWindow));
     }
 
     void isVisible(isVisible_in *in, isVisible_out *out)
     {
+        ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
-        out->visibility = proxy->getWidget()->getQWidget()->isVisible();
+        out->visibility = proxy->getWidget()->isVisible();
     }
 
     void getPosition(getPosition_in *in, getPosition_out *out)
     {
+        ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
         Window *window = proxy->getWidget();
-        out->x = window->pos().x();
-        out->y = window->pos().y();
+        QPoint pos = window->getPosition();
+        out->x = pos.x();
+        out->y = pos.y();
     }
 
     void setPosition(setPosition_in *in, setPosition_out *out)
@@ -470,15 +516,18 @@ public:
         ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
         Window *window = proxy->getWidget();
-        SIM::getInstance()->setPosition(window, in->x, in->y);
+        window->mirrorPosition(in->x, in->y);
+        SIM::getInstance()->update(window, Property::Position, UI_SLOT(onSetPosition), in->x, in->y);
     }
 
     void getSize(getSize_in *in, getSize_out *out)
     {
+        ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
         Window *window = proxy->getWidget();
-        out->w = window->size().width();
-        out->h = window->size().height();
+        QSize size = window->getSize();
+        out->w = size.width();
+        out->h = size.height();
     }
 
     void setSize(setSize_in *in, setSize_out *out)
@@ -486,14 +535,15 @@ public:
         ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
         Window *window = proxy->getWidget();
-        SIM::getInstance()->setSize(window, in->w, in->h);
+        window->mirrorSize(in->w, in->h);
+        SIM::getInstance()->update(window, Property::Size, UI_SLOT(onSetSize), in->w, in->h);
     }
 
     void getTitle(getTitle_in *in, getTitle_out *out)
     {
+        ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
-        QWidget *window = proxy->getWidget()->getQWidget();
-        out->title = static_cast<QDialog*>(window)->windowTitle().toStdString();
+        out->title = proxy->getWidget()->getTitle();
     }
 
     void setTitle(setTitle_in *in, setTitle_out *out)
@@ -501,7 +551,8 @@ public:
         ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
         Window *window = proxy->getWidget();
-        SIM::getInstance()->setTitle(window, in->title);
+        window->mirrorTitle(in->title);
+        SIM::getInstance()->update(window, Property::Title, UI_SLOT(onSetTitle), in->title);
     }
 
     void setWindowEnabled(setWindowEnabled_in *in, setWindowEnabled_out *out)
@@ -509,7 +560,148 @@ public:
         ASSERT_THREAD(!UI);
         Proxy *proxy = handles.get(in->handle);
         Window *window = proxy->getWidget();
-        SIM::getInstance()->setWindowEnabled(window, in->enabled);
+        SIM::getInstance()->update(window, Property::Enabled, UI_SLOT(onSetWindowEnabled), in->enabled);
+    }
+
+    void beginBatch(beginBatch_in *in, beginBatch_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        Proxy *proxy = handles.get(in->handle);
+        SIM::getInstance()->beginBatch(proxy);
+    }
+
+    void commitBatch(commitBatch_in *in, commitBatch_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        Proxy *proxy = handles.get(in->handle);
+        SIM::getInstance()->commitBatch(proxy);
+    }
+
+    // same as the simUI.setXXXValue function of the widget type:
+    void setWidgetValue(Widget *widget, const widget_value &value, bool suppressEvents)
+    {
+        if(!widget->setMirrorValue(value, suppressEvents))
+            throw std::runtime_error((boost::format("widget id %d: widget type has no value") % widget->getId()).str());
+    }
+
+    void setWidgetValues(setWidgetValues_in *in, setWidgetValues_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        Proxy *proxy = handles.get(in->handle);
+
+        std::vector<Widget *> widgets;
+        widgets.reserve(in->values.size());
+        for(const widget_value &value : in->values)
+            widgets.push_back(getWidget(in->handle, value.id));
+
+        // all the changes are applied in one pass of the UI thread (see commitBatch):
+        SIM::getInstance()->beginBatch(proxy);
+        try
+        {
+            for(size_t i = 0; i < widgets.size(); i++)
+                setWidgetValue(widgets[i], in->values[i], in->suppressEvents);
+        }
+        catch(...)
+        {
+            SIM::getInstance()->commitBatch(proxy);
+            throw;
+        }
+        SIM::getInstance()->commitBatch(proxy);
+    }
+
+    // same as the simUI.getXXXValue function of the widget type (but reads
+    // only the mirrored state); returns false if the widget has no value
+    bool getWidgetValue(Widget *widget, widget_value &value)
+    {
+        value.id = widget->getId();
+        value.number = 0;
+        value.text.clear();
+        value.isText = false;
+        return widget->getMirrorValue(value);
+    }
+
+    void getWidgetValues(getWidgetValues_in *in, getWidgetValues_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        Proxy *proxy = handles.get(in->handle);
+
+        widget_value value;
+        if(in->ids.empty())
+        {
+            // all the widgets which have a value, in no particular order:
+            proxy->widgets.forEach([&](Widget *widget) {
+                if(getWidgetValue(widget, value))
+                    out->values.push_back(value);
+            });
+        }
+        else
+        {
+            out->values.reserve(in->ids.size());
+            for(int id : in->ids)
+            {
+                Widget *widget = getWidget(in->handle, id);
+                if(!getWidgetValue(widget, value))
+                    throw std::runtime_error((boost::format("widget id %d: widget type has no value") % id).str());
+                out->values.push_back(value);
+            }
+        }
+    }
+
+    void getCoalescingStats(getCoalescingStats_in *in, getCoalescingStats_out *out)
+    {
+        out->updates = CommandStats::updates;
+        out->merged = CommandStats::merged;
+    }
+
+    void getWidgetTypes(getWidgetTypes_in *in, getWidgetTypes_out *out)
+    {
+        out->types = Widget::getWidgetTypes();
+    }
+
+    void getStats(getStats_in *in, getStats_out *out)
+    {
+        Stats::get(out->stats);
+    }
+
+    void resetStats(resetStats_in *in, resetStats_out *out)
+    {
+        Stats::reset();
+    }
+
+    void setStatsEnabled(setStatsEnabled_in *in, setStatsEnabled_out *out)
+    {
+        Stats::setEnabled(in->enabled);
+    }
+
+    void setCommandBudget(setCommandBudget_in *in, setCommandBudget_out *out)
+    {
+        if(in->ms < 0)
+            throw std::runtime_error("invalid budget");
+        UI::commandBudget = in->ms;
+    }
+
+    void getCommandBacklog(getCommandBacklog_in *in, getCommandBacklog_out *out)
+    {
+        out->backlog = UI::getInstance()->commands.size();
+        out->bulkBacklog = UI::getInstance()->bulkCommands.size();
+        out->maxBacklog = CommandStats::maxBacklog;
+    }
+
+    void setTraceEnabled(setTraceEnabled_in *in, setTraceEnabled_out *out)
+    {
+        Trace::setEnabled(in->enabled);
+    }
+
+    void dumpTrace(dumpTrace_in *in, dumpTrace_out *out)
+    {
+        Trace::dump(in->filename);
+    }
+
+    void pollEvents(pollEvents_in *in, pollEvents_out *out)
+    {
+        ASSERT_THREAD(!UI);
+        Proxy *proxy = handles.get(in->handle);
+        SIM::getInstance()->takeEvents(proxy, out->events);
     }
 
     void setImageData(setImageData_in *in, setImageData_out *out)
@@ -538,7 +730,7 @@ public:
         simInt resolution[2] = {in->width, in->height};
         simTransformImage((simUChar *)img, resolution, 4, NULL, NULL, NULL);
 
-        SIM::getInstance()->setImage(imageWidget, img, in->width, in->height);
+        SIM::getInstance()->updateBulk(imageWidget, Property::Image, UI_SLOT(onSetImage), makeImageData(img), in->width, in->height);
 #endif
     }
 
@@ -553,14 +745,14 @@ public:
             throw std::runtime_error(ss.str());
         }
 
-        SIM::getInstance()->setEnabled(widget, in->enabled);
+        SIM::getInstance()->update(widget, Property::Enabled, UI_SLOT(onSetEnabled), in->enabled);
     }
 
     void getCurrentTab(getCurrentTab_in *in, getCurrentTab_out *out)
     {
 #if WIDGET_TABS
-        QTabWidget *tabs = getQWidget<QTabWidget>(in->handle, in->id, "tabs");
-        out->index = tabs->currentIndex();
+        Tabs *tabs = getWidget<Tabs>(in->handle, in->id, "tabs");
+        out->index = tabs->getCurrentTab();
 #endif
     }
 
@@ -569,13 +761,15 @@ public:
 #if WIDGET_TABS
         ASSERT_THREAD(!UI);
         Tabs *tabs = getWidget<Tabs>(in->handle, in->id, "tabs");
-        SIM::getInstance()->setCurrentTab(tabs, in->index, in->suppressEvents);
+        tabs->mirrorCurrentTab(in->index);
+        SIM::getInstance()->update(tabs, Property::CurrentIndex, UI_SLOT(onSetCurrentTab), in->index, in->suppressEvents);
 #endif
     }
 
     void getWidgetVisibility(getWidgetVisibility_in *in, getWidgetVisibility_out *out)
     {
-        QWidget *widget = getQWidget<QWidget>(in->handle, in->id, "widget");
+        ASSERT_THREAD(!UI);
+        Widget *widget = getWidget<Widget>(in->handle, in->id, "widget");
         out->visibility = widget->isVisible();
     }
 
@@ -590,7 +784,8 @@ public:
             throw std::runtime_error(ss.str());
         }
 
-        SIM::getInstance()->setWidgetVisibility(widget, in->visibility);
+        widget->mirrorVisibility(in->visibility);
+        SIM::getInstance()->update(widget, Property::Visibility, UI_SLOT(onSetWidgetVisibility), in->visibility);
     }
 
     void getCurrentEditWidget(getCurrentEditWidget_in *in, getCurrentEditWidget_out *out)
@@ -620,6 +815,7 @@ public:
         if(in->id == -1) return;
         Edit *edit = getWidget<Edit>(in->handle, in->id, "edit");
         QLineEdit *qedit = static_cast<QLineEdit*>(edit->getQWidget());
+        if(!qedit) return; // not created yet (see LayoutWidget::createQtWidgetLazily)
         qedit->setFocus();
         qedit->selectAll();
 #endif
@@ -629,7 +825,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->replot(plot);
+        SIM::getInstance()->call(plot, UI_SLOT(onReplot));
 #endif
     }
 
@@ -638,7 +834,7 @@ public:
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
         plot->curveNameMustNotExist(in->name);
-        SIM::getInstance()->addCurve(plot, in->type, in->name, in->color, in->style, &in->options);
+        SIM::getInstance()->callSync(plot, UI_SLOT(onAddCurve), in->type, in->name, in->color, in->style, &in->options);
 #endif
     }
 
@@ -648,7 +844,7 @@ public:
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
         QCPAbstractPlottable *curve = plot->curveNameMustExist(in->name)->second;
         plot->curveMustBeTime(curve);
-        SIM::getInstance()->addCurveTimePoints(plot, in->name, in->x, in->y);
+        SIM::getInstance()->callBulk(plot, UI_SLOT(onAddCurveTimePoints), in->name, makePayload(std::move(in->x)), makePayload(std::move(in->y)));
 #endif
     }
 
@@ -658,7 +854,7 @@ public:
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
         QCPAbstractPlottable *curve = plot->curveNameMustExist(in->name)->second;
         plot->curveMustBeXY(curve);
-        SIM::getInstance()->addCurveXYPoints(plot, in->name, in->t, in->x, in->y);
+        SIM::getInstance()->callBulk(plot, UI_SLOT(onAddCurveXYPoints), in->name, makePayload(std::move(in->t)), makePayload(std::move(in->x)), makePayload(std::move(in->y)));
 #endif
     }
 
@@ -667,7 +863,7 @@ public:
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
         plot->curveNameMustExist(in->name);
-        SIM::getInstance()->clearCurve(plot, in->name);
+        SIM::getInstance()->call(plot, UI_SLOT(onClearCurve), in->name);
 #endif
     }
 
@@ -676,7 +872,7 @@ public:
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
         plot->curveNameMustExist(in->name);
-        SIM::getInstance()->removeCurve(plot, in->name);
+        SIM::getInstance()->callSync(plot, UI_SLOT(onRemoveCurve), in->name);
 #endif
     }
 
@@ -684,7 +880,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setPlotRanges(plot, in->xmin, in->xmax, in->ymin, in->ymax);
+        SIM::getInstance()->update(plot, Property::PlotRanges, UI_SLOT(onSetPlotRanges), in->xmin, in->xmax, in->ymin, in->ymax);
 #endif
     }
 
@@ -692,7 +888,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setPlotXRange(plot, in->xmin, in->xmax);
+        SIM::getInstance()->update(plot, Property::PlotXRange, UI_SLOT(onSetPlotXRange), in->xmin, in->xmax);
 #endif
     }
 
@@ -700,7 +896,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setPlotYRange(plot, in->ymin, in->ymax);
+        SIM::getInstance()->update(plot, Property::PlotYRange, UI_SLOT(onSetPlotYRange), in->ymin, in->ymax);
 #endif
     }
 
@@ -708,7 +904,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->growPlotRanges(plot, in->xmin, in->xmax, in->ymin, in->ymax);
+        SIM::getInstance()->call(plot, UI_SLOT(onGrowPlotRanges), in->xmin, in->xmax, in->ymin, in->ymax);
 #endif
     }
 
@@ -716,7 +912,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->growPlotXRange(plot, in->xmin, in->xmax);
+        SIM::getInstance()->call(plot, UI_SLOT(onGrowPlotXRange), in->xmin, in->xmax);
 #endif
     }
 
@@ -724,7 +920,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->growPlotYRange(plot, in->ymin, in->ymax);
+        SIM::getInstance()->call(plot, UI_SLOT(onGrowPlotYRange), in->ymin, in->ymax);
 #endif
     }
 
@@ -732,7 +928,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setPlotLabels(plot, in->x, in->y);
+        SIM::getInstance()->call(plot, UI_SLOT(onSetPlotLabels), in->x, in->y);
 #endif
     }
 
@@ -740,7 +936,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setPlotXLabel(plot, in->label);
+        SIM::getInstance()->call(plot, UI_SLOT(onSetPlotXLabel), in->label);
 #endif
     }
 
@@ -748,7 +944,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setPlotYLabel(plot, in->label);
+        SIM::getInstance()->call(plot, UI_SLOT(onSetPlotYLabel), in->label);
 #endif
     }
 
@@ -757,7 +953,7 @@ public:
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
         plot->curveNameMustExist(in->name);
-        SIM::getInstance()->rescaleAxes(plot, in->name, in->onlyEnlargeX, in->onlyEnlargeY);
+        SIM::getInstance()->call(plot, UI_SLOT(onRescaleAxes), in->name, in->onlyEnlargeX, in->onlyEnlargeY);
 #endif
     }
 
@@ -765,7 +961,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->rescaleAxesAll(plot, in->onlyEnlargeX, in->onlyEnlargeY);
+        SIM::getInstance()->call(plot, UI_SLOT(onRescaleAxesAll), in->onlyEnlargeX, in->onlyEnlargeY);
 #endif
     }
 
@@ -773,7 +969,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setMouseOptions(plot, in->panX, in->panY, in->zoomX, in->zoomY);
+        SIM::getInstance()->call(plot, UI_SLOT(onSetMouseOptions), in->panX, in->panY, in->zoomX, in->zoomY);
 #endif
     }
 
@@ -781,7 +977,7 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        SIM::getInstance()->setLegendVisibility(plot, in->visible);
+        SIM::getInstance()->call(plot, UI_SLOT(onSetLegendVisibility), in->visible);
 #endif
     }
 
@@ -789,7 +985,8 @@ public:
     {
 #if WIDGET_PLOT
         Plot *plot = getWidget<Plot>(in->handle, in->id, "plot");
-        plot->getCurveData(in->name, out->x, out->x, out->y);
+        // (reads the Qt widget: wait for the pending commands)
+        SIM::getInstance()->callSync(plot, UI_SLOT(onGetCurveData), in->name, &out->x, &out->y);
 #endif
     }
 
@@ -797,7 +994,7 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->clearTable(table, in->suppressEvents);
+        SIM::getInstance()->call(table, UI_SLOT(onClearTable), in->suppressEvents);
 #endif
     }
 
@@ -805,7 +1002,8 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->setRowCount(table, in->count, in->suppressEvents);
+        table->mirrorRowCount(in->count);
+        SIM::getInstance()->call(table, UI_SLOT(onSetRowCount), in->count, in->suppressEvents);
 #endif
     }
 
@@ -815,14 +1013,15 @@ public:
 #if WIDGET_TABLE
         if(Table *table = dynamic_cast<Table*>(widget))
         {
-            SIM::getInstance()->setColumnCountTable(table, in->count, in->suppressEvents);
+            table->mirrorColumnCount(in->count);
+            SIM::getInstance()->call(table, UI_SLOT(onSetColumnCountTable), in->count, in->suppressEvents);
             return;
         }
 #endif
 #if WIDGET_TREE
         if(Tree *tree = dynamic_cast<Tree*>(widget))
         {
-            SIM::getInstance()->setColumnCountTree(tree, in->count, in->suppressEvents);
+            SIM::getInstance()->call(tree, UI_SLOT(onSetColumnCountTree), in->count, in->suppressEvents);
             return;
         }
 #endif
@@ -839,7 +1038,7 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->setItem(table, in->row, in->column, in->text, in->suppressEvents);
+        SIM::getInstance()->callBulk(table, UI_SLOT(onSetItem), in->row, in->column, in->text, in->suppressEvents);
 #endif
     }
 
@@ -847,13 +1046,14 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->setItemImage(table, in->row, in->column, in->data, in->width, in->height, in->suppressEvents);
+        SIM::getInstance()->callBulk(table, UI_SLOT(onSetItemImage), in->row, in->column, makePayload(std::move(in->data)), in->width, in->height, in->suppressEvents);
 #endif
     }
 
     void getRowCount(getRowCount_in *in, getRowCount_out *out)
     {
 #if WIDGET_TABLE
+        ASSERT_THREAD(!UI);
         Table *table = getWidget<Table>(in->handle, in->id, "table");
         out->count = table->getRowCount();
 #endif
@@ -872,7 +1072,7 @@ public:
 #if WIDGET_TREE
         if(Tree *tree = dynamic_cast<Tree*>(widget))
         {
-            out->count = tree->getColumnCount();
+            SIM::getInstance()->callSync(tree, UI_SLOT(onGetColumnCountTree), &out->count);
             return;
         }
 #endif
@@ -889,7 +1089,7 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        out->text = table->getItem(in->row, in->column);
+        SIM::getInstance()->callSync(table, UI_SLOT(onGetItem), in->row, in->column, &out->text);
 #endif
     }
 
@@ -897,7 +1097,7 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->setRowHeaderText(table, in->row, in->text);
+        SIM::getInstance()->call(table, UI_SLOT(onSetRowHeaderText), in->row, in->text);
 #endif
     }
 
@@ -907,14 +1107,14 @@ public:
 #if WIDGET_TABLE
         if(Table *table = dynamic_cast<Table*>(widget))
         {
-            SIM::getInstance()->setColumnHeaderTextTable(table, in->column, in->text);
+            SIM::getInstance()->call(table, UI_SLOT(onSetColumnHeaderTextTable), in->column, in->text);
             return;
         }
 #endif
 #if WIDGET_TREE
         if(Tree *tree = dynamic_cast<Tree*>(widget))
         {
-            SIM::getInstance()->setColumnHeaderTextTree(tree, in->column, in->text);
+            SIM::getInstance()->call(tree, UI_SLOT(onSetColumnHeaderTextTree), in->column, in->text);
             return;
         }
 #endif
@@ -931,7 +1131,7 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->setItemEditable(table, in->row, in->column, in->editable);
+        SIM::getInstance()->call(table, UI_SLOT(onSetItemEditable), in->row, in->column, in->editable);
 #endif
     }
 
@@ -941,14 +1141,14 @@ public:
 #if WIDGET_TABLE
         if(Table *table = dynamic_cast<Table*>(widget))
         {
-            out->state = table->saveState();
+            SIM::getInstance()->callSync(table, UI_SLOT(onSaveStateTable), &out->state);
             return;
         }
 #endif
 #if WIDGET_TREE
         if(Tree *tree = dynamic_cast<Tree*>(widget))
         {
-            out->state = tree->saveState();
+            SIM::getInstance()->callSync(tree, UI_SLOT(onSaveStateTree), &out->state);
             return;
         }
 #endif
@@ -967,14 +1167,14 @@ public:
 #if WIDGET_TABLE
         if(Table *table = dynamic_cast<Table*>(widget))
         {
-            SIM::getInstance()->restoreStateTable(table, in->state);
+            SIM::getInstance()->call(table, UI_SLOT(onRestoreStateTable), in->state);
             return;
         }
 #endif
 #if WIDGET_TREE
         if(Tree *tree = dynamic_cast<Tree*>(widget))
         {
-            SIM::getInstance()->restoreStateTree(tree, in->state);
+            SIM::getInstance()->call(tree, UI_SLOT(onRestoreStateTree), in->state);
             return;
         }
 #endif
@@ -991,7 +1191,7 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->setRowHeight(table, in->row, in->min_size, in->max_size);
+        SIM::getInstance()->call(table, UI_SLOT(onSetRowHeight), in->row, in->min_size, in->max_size);
 #endif
     }
 
@@ -1001,14 +1201,14 @@ public:
 #if WIDGET_TABLE
         if(Table *table = dynamic_cast<Table*>(widget))
         {
-            SIM::getInstance()->setColumnWidthTable(table, in->column, in->min_size, in->max_size);
+            SIM::getInstance()->call(table, UI_SLOT(onSetColumnWidthTable), in->column, in->min_size, in->max_size);
             return;
         }
 #endif
 #if WIDGET_TREE
         if(Tree *tree = dynamic_cast<Tree*>(widget))
         {
-            SIM::getInstance()->setColumnWidthTree(tree, in->column, in->min_size, in->max_size);
+            SIM::getInstance()->call(tree, UI_SLOT(onSetColumnWidthTree), in->column, in->min_size, in->max_size);
             return;
         }
 #endif
@@ -1025,7 +1225,7 @@ public:
     {
 #if WIDGET_TABLE
         Table *table = getWidget<Table>(in->handle, in->id, "table");
-        SIM::getInstance()->setTableSelection(table, in->row, in->column, in->suppressEvents);
+        SIM::getInstance()->call(table, UI_SLOT(onSetTableSelection), in->row, in->column, in->suppressEvents);
 #endif
     }
 
@@ -1033,7 +1233,8 @@ public:
     {
 #if WIDGET_PROGRESSBAR
         Progressbar *progressbar = getWidget<Progressbar>(in->handle, in->id, "progressbar");
-        SIM::getInstance()->setProgress(progressbar, in->value);
+        progressbar->mirrorValue(in->value);
+        SIM::getInstance()->update(progressbar, Property::Value, UI_SLOT(onSetProgress), in->value);
 #endif
     }
 
@@ -1041,7 +1242,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->clearTree(tree, in->suppressEvents);
+        SIM::getInstance()->call(tree, UI_SLOT(onClearTree), in->suppressEvents);
 #endif
     }
 
@@ -1049,7 +1250,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->addTreeItem(tree, in->item_id, in->parent_id, in->text, in->expanded, in->suppressEvents);
+        SIM::getInstance()->callBulk(tree, UI_SLOT(onAddTreeItem), in->item_id, in->parent_id, in->text, in->expanded, in->suppressEvents);
 #endif
     }
 
@@ -1057,7 +1258,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->updateTreeItemText(tree, in->item_id, in->text);
+        SIM::getInstance()->call(tree, UI_SLOT(onUpdateTreeItemText), in->item_id, in->text);
 #endif
     }
 
@@ -1065,7 +1266,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->updateTreeItemParent(tree, in->item_id, in->parent_id, in->suppressEvents);
+        SIM::getInstance()->call(tree, UI_SLOT(onUpdateTreeItemParent), in->item_id, in->parent_id, in->suppressEvents);
 #endif
     }
 
@@ -1073,7 +1274,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->removeTreeItem(tree, in->item_id, in->suppressEvents);
+        SIM::getInstance()->call(tree, UI_SLOT(onRemoveTreeItem), in->item_id, in->suppressEvents);
 #endif
     }
 
@@ -1081,7 +1282,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->setTreeSelection(tree, in->item_id, in->suppressEvents);
+        SIM::getInstance()->call(tree, UI_SLOT(onSetTreeSelection), in->item_id, in->suppressEvents);
 #endif
     }
 
@@ -1089,7 +1290,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->expandAll(tree, in->suppressEvents);
+        SIM::getInstance()->call(tree, UI_SLOT(onExpandAll), in->suppressEvents);
 #endif
     }
 
@@ -1097,7 +1298,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->collapseAll(tree, in->suppressEvents);
+        SIM::getInstance()->call(tree, UI_SLOT(onCollapseAll), in->suppressEvents);
 #endif
     }
 
@@ -1105,7 +1306,7 @@ public:
     {
 #if WIDGET_TREE
         Tree *tree = getWidget<Tree>(in->handle, in->id, "tree");
-        SIM::getInstance()->expandToDepth(tree, in->depth, in->suppressEvents);
+        SIM::getInstance()->call(tree, UI_SLOT(onExpandToDepth), in->depth, in->suppressEvents);
 #endif
     }
 
@@ -1113,7 +1314,7 @@ public:
     {
 #if WIDGET_TEXTBROWSER
         TextBrowser *textbrowser = getWidget<TextBrowser>(in->handle, in->id, "text-browser");
-        SIM::getInstance()->setText(textbrowser, in->text, in->suppressEvents);
+        SIM::getInstance()->update(textbrowser, Property::Text, UI_SLOT(onSetText), in->text, in->suppressEvents);
 #endif
     }
 
@@ -1121,7 +1322,7 @@ public:
     {
 #if WIDGET_TEXTBROWSER
         TextBrowser *textbrowser = getWidget<TextBrowser>(in->handle, in->id, "text-browser");
-        SIM::getInstance()->setUrl(textbrowser, in->url);
+        SIM::getInstance()->update(textbrowser, Property::Url, UI_SLOT(onSetUrl), in->url);
 #endif
     }
 
@@ -1132,7 +1333,7 @@ public:
         if(scene3d->nodeExists(in->nodeId)) throw std::runtime_error("node id already exists");
         if(!scene3d->nodeExists(in->parentNodeId)) throw std::runtime_error("parent node id does not exist");
         if(!scene3d->nodeTypeIsValid(in->type)) throw std::runtime_error("invalid node type");
-        SIM::getInstance()->addScene3DNode(scene3d, in->nodeId, in->parentNodeId, in->type);
+        SIM::getInstance()->callSync(scene3d, UI_SLOT(onAddScene3DNode), in->nodeId, in->parentNodeId, in->type);
 #endif
     }
 
@@ -1141,7 +1342,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->removeScene3DNode(scene3d, in->nodeId);
+        SIM::getInstance()->callSync(scene3d, UI_SLOT(onRemoveScene3DNode), in->nodeId);
 #endif
     }
 
@@ -1150,7 +1351,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->setScene3DNodeEnabled(scene3d, in->nodeId, in->enabled);
+        SIM::getInstance()->call(scene3d, UI_SLOT(onSetScene3DNodeEnabled), in->nodeId, in->enabled);
 #endif
     }
 
@@ -1159,7 +1360,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->setScene3DIntParam(scene3d, in->nodeId, in->paramName, in->value);
+        SIM::getInstance()->call(scene3d, UI_SLOT(onSetScene3DIntParam), in->nodeId, in->paramName, in->value);
 #endif
     }
 
@@ -1168,7 +1369,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->setScene3DFloatParam(scene3d, in->nodeId, in->paramName, in->value);
+        SIM::getInstance()->call(scene3d, UI_SLOT(onSetScene3DFloatParam), in->nodeId, in->paramName, in->value);
 #endif
     }
 
@@ -1177,7 +1378,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->setScene3DStringParam(scene3d, in->nodeId, in->paramName, in->value);
+        SIM::getInstance()->call(scene3d, UI_SLOT(onSetScene3DStringParam), in->nodeId, in->paramName, in->value);
 #endif
     }
 
@@ -1186,7 +1387,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->setScene3DVector2Param(scene3d, in->nodeId, in->paramName, in->x, in->y);
+        SIM::getInstance()->call(scene3d, UI_SLOT(onSetScene3DVector2Param), in->nodeId, in->paramName, in->x, in->y);
 #endif
     }
 
@@ -1195,7 +1396,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->setScene3DVector3Param(scene3d, in->nodeId, in->paramName, in->x, in->y, in->z);
+        SIM::getInstance()->call(scene3d, UI_SLOT(onSetScene3DVector3Param), in->nodeId, in->paramName, in->x, in->y, in->z);
 #endif
     }
 
@@ -1204,7 +1405,7 @@ public:
 #if WIDGET_SCENE3D
         Scene3D *scene3d = getWidget<Scene3D>(in->handle, in->id, "scene3d");
         if(!scene3d->nodeExists(in->nodeId)) throw std::runtime_error("invalid node id");
-        SIM::getInstance()->setScene3DVector4Param(scene3d, in->nodeId, in->paramName, in->x, in->y, in->z, in->w);
+        SIM::getInstance()->call(scene3d, UI_SLOT(onSetScene3DVector4Param), in->nodeId, in->paramName, in->x, in->y, in->z, in->w);
 #endif
     }
 
@@ -1213,7 +1414,7 @@ public:
 #if WIDGET_SVG
         SVG *svg = getWidget<SVG>(in->handle, in->id, "svg");
         QString file = QString::fromStdString(in->file);
-        SIM::getInstance()->svgLoadFile(svg, file);
+        SIM::getInstance()->call(svg, UI_SLOT(onSvgLoadFile), file);
 #endif
     }
 
@@ -1222,7 +1423,7 @@ public:
 #if WIDGET_SVG
         SVG *svg = getWidget<SVG>(in->handle, in->id, "svg");
         QByteArray data(in->data.data(), in->data.size());
-        SIM::getInstance()->svgLoadData(svg, data);
+        SIM::getInstance()->call(svg, UI_SLOT(onSvgLoadData), data);
 #endif
     }
 
@@ -88,4 +88,39 @@ function simUI.setScene3DNodeParam(ui,widget,nodeId,paramName,paramValue)
     end
 end
 
+--@fun setValues set the values of several widgets at once (slider, spinbox, edit, label, checkbox, radiobutton, progressbar, or selected index of a combobox)
+--@arg int ui the ui handle
+--@arg table values a table mapping widget identifiers to values (numbers, or strings for edit and label widgets)
+--@arg bool suppressEvents if true (default), no event will be generated from this call
+function simUI.setValues(ui,values,suppressEvents)
+    local list={}
+    for id,value in pairs(values) do
+        if type(value)=='string' then
+            table.insert(list,{id=id,text=value,isText=true})
+        elseif type(value)=='number' then
+            table.insert(list,{id=id,number=value})
+        else
+            error(string.format('unsupported value type for widget %s: %s',id,type(value)))
+        end
+    end
+    if suppressEvents==nil then suppressEvents=true end
+    simUI.setWidgetValues(ui,list,suppressEvents)
+end
+
+--@fun getValues get the values of several widgets at once (slider, spinbox, edit, label, checkbox, radiobutton, progressbar, or selected index of a combobox)
+--@arg int ui the ui handle
+--@arg table ids the widget identifiers (optional: if not given, the values of all the widgets are returned)
+--@ret table values a table mapping widget identifiers to values
+function simUI.getValues(ui,ids)
+    local values={}
+    for i,v in ipairs(simUI.getWidgetValues(ui,ids or {})) do
+        if v.isText then
+            values[v.id]=v.text
+        else
+            values[v.id]=v.number
+        end
+    end
+    return values
+end
+
 return simUI
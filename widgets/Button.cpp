@@ -68,7 +68,7 @@ QWidget * Button::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
             button->setIcon(button->style()->standardIcon(sp));
         }
     }
-    QObject::connect(button, &QPushButton::clicked, ui, &UI::onButtonClick);
+    QObject::connect(button, &QPushButton::clicked, ui, [=] {ui->onButtonClick(this);});
     setQWidget(button);
     setProxy(proxy);
     return button;
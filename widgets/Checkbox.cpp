@@ -2,6 +2,7 @@
 
 #include "XMLUtils.h"
 
+#include "SIM.h"
 #include "UI.h"
 
 #include <QCheckBox>
@@ -27,6 +28,8 @@ void Checkbox::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::
 
     auto_exclusive = xmlutils::getAttrBool(e, "auto-exclusive", false);
 
+    mirror_value = checked && checkable ? Qt::Checked : Qt::Unchecked;
+
     onchange = xmlutils::getAttrStr(e, "on-change", "");
 }
 
@@ -39,7 +42,7 @@ QWidget * Checkbox::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     checkbox->setCheckable(checkable);
     checkbox->setAutoExclusive(auto_exclusive);
     checkbox->setChecked(checked);
-    QObject::connect(checkbox, &QCheckBox::stateChanged, ui, &UI::onValueChangeInt);
+    QObject::connect(checkbox, &QCheckBox::stateChanged, ui, [=](int value) {ui->onValueChangeInt(this, value);});
     setQWidget(checkbox);
     setProxy(proxy);
     return checkbox;
@@ -75,9 +78,34 @@ void Checkbox::setValue(Qt::CheckState value, bool suppressSignals)
     qcheckbox->blockSignals(oldSignalsState);
 }
 
+void Checkbox::mirrorValue(Qt::CheckState value)
+{
+    setterChangedMirror();
+    mirror_value = value;
+}
+
 Qt::CheckState Checkbox::getValue()
 {
-    QCheckBox *qcheckbox = static_cast<QCheckBox*>(getQWidget());
-    return qcheckbox->checkState();
+    return mirror_value;
+}
+
+bool Checkbox::getMirrorValue(widget_value &val)
+{
+    val.number = convertValueToInt(getValue());
+    return true;
+}
+
+bool Checkbox::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, false);
+    Qt::CheckState v = convertValueFromInt(int(val.number));
+    mirrorValue(v);
+    SIM::getInstance()->update(this, Property::Value, UI_SLOT(onSetCheckboxValue), v, suppressEvents);
+    return true;
+}
+
+void Checkbox::mirrorValueChange(int value)
+{
+    mirror_value = static_cast<Qt::CheckState>(value);
 }
 
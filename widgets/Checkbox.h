@@ -24,6 +24,9 @@ protected:
     bool checkable;
     bool auto_exclusive;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    Qt::CheckState mirror_value;
+
 public:
     Checkbox();
     virtual ~Checkbox();
@@ -34,7 +37,13 @@ public:
     Qt::CheckState convertValueFromInt(int value);
     int convertValueToInt(Qt::CheckState value);
     void setValue(Qt::CheckState value, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorValue(Qt::CheckState value);
     Qt::CheckState getValue();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
+    void mirrorValueChange(int value);
 
     friend class SIM;
 };
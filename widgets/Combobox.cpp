@@ -2,8 +2,10 @@
 
 #include "XMLUtils.h"
 
+#include "SIM.h"
 #include "UI.h"
 
+#include <algorithm>
 #include <iostream>
 #include <boost/foreach.hpp>
 
@@ -30,6 +32,9 @@ void Combobox::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::
         items.push_back(itemName ? itemName : "");
     }
 
+    mirror_items = items;
+    mirror_selectedIndex = items.empty() ? -1 : 0;
+
     onchange = xmlutils::getAttrStr(e, "on-change", "");
 }
 
@@ -43,7 +48,7 @@ QWidget * Combobox::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     {
         combobox->addItem(QString::fromStdString(*it));
     }
-    QObject::connect(combobox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), ui, &UI::onValueChangeInt);
+    QObject::connect(combobox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), ui, [=](int index) {ui->onValueChangeInt(this, index);});
     setQWidget(combobox);
     setProxy(proxy);
     return combobox;
@@ -65,28 +70,19 @@ void Combobox::removeItem(int index, bool suppressSignals)
     qcombobox->blockSignals(oldSignalsState);
 }
 
-void Combobox::setItems(std::vector<std::string> items, int index, bool suppressSignals)
+void Combobox::setItems(const std::vector<std::string> &items, int index, bool suppressSignals)
 {
     QComboBox *qcombobox = static_cast<QComboBox*>(getQWidget());
     bool oldSignalsState = qcombobox->blockSignals(suppressSignals);
     qcombobox->clear();
     QStringList qitems;
-    BOOST_FOREACH(std::string &item, items)
+    BOOST_FOREACH(const std::string &item, items)
         qitems.push_back(QString::fromStdString(item));
     qcombobox->addItems(qitems);
     qcombobox->setCurrentIndex(index);
     qcombobox->blockSignals(oldSignalsState);
 }
 
-std::vector<std::string> Combobox::getItems()
-{
-    QComboBox *qcombobox = static_cast<QComboBox*>(getQWidget());
-    std::vector<std::string> ret;
-    for(int i = 0; i < qcombobox->count(); i++)
-        ret.push_back(qcombobox->itemText(i).toStdString());
-    return ret;
-}
-
 void Combobox::setSelectedIndex(int index, bool suppressSignals)
 {
     QComboBox *qcombobox = static_cast<QComboBox*>(getQWidget());
@@ -95,21 +91,80 @@ void Combobox::setSelectedIndex(int index, bool suppressSignals)
     qcombobox->blockSignals(oldSignalsState);
 }
 
+// the mirror* methods follow the index semantics of QComboBox:
+
+void Combobox::mirrorInsertItem(int index, std::string text)
+{
+    setterChangedMirror();
+    index = std::min(std::max(index, 0), count());
+    mirror_items.insert(mirror_items.begin() + index, text);
+    if(count() == 1)
+        mirror_selectedIndex = 0;
+    else if(mirror_selectedIndex != -1 && index <= mirror_selectedIndex)
+        mirror_selectedIndex++;
+}
+
+void Combobox::mirrorRemoveItem(int index)
+{
+    setterChangedMirror();
+    if(index < 0 || index >= count()) return;
+    mirror_items.erase(mirror_items.begin() + index);
+    if(index < mirror_selectedIndex)
+        mirror_selectedIndex--;
+    else if(index == mirror_selectedIndex)
+        mirror_selectedIndex = std::min(mirror_selectedIndex, count() - 1);
+}
+
+void Combobox::mirrorItems(std::vector<std::string> items, int index)
+{
+    setterChangedMirror();
+    mirror_items = items;
+    mirrorSelectedIndex(index);
+}
+
+void Combobox::mirrorSelectedIndex(int index)
+{
+    setterChangedMirror();
+    mirror_selectedIndex = index >= 0 && index < count() ? index : -1;
+}
+
+std::vector<std::string> Combobox::getItems()
+{
+    return mirror_items;
+}
+
 int Combobox::getSelectedIndex()
 {
-    QComboBox *qcombobox = static_cast<QComboBox*>(getQWidget());
-    return qcombobox->currentIndex();
+    return mirror_selectedIndex;
+}
+
+bool Combobox::getMirrorValue(widget_value &val)
+{
+    val.number = getSelectedIndex();
+    return true;
+}
+
+bool Combobox::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, false);
+    mirrorSelectedIndex(int(val.number));
+    SIM::getInstance()->update(this, Property::CurrentIndex, UI_SLOT(onSetComboboxSelectedIndex), int(val.number), suppressEvents);
+    return true;
+}
+
+void Combobox::mirrorValueChange(int value)
+{
+    mirror_selectedIndex = value;
 }
 
 int Combobox::count()
 {
-    QComboBox *qcombobox = static_cast<QComboBox*>(getQWidget());
-    return qcombobox->count();
+    return mirror_items.size();
 }
 
 std::string Combobox::itemText(int index)
 {
-    QComboBox *qcombobox = static_cast<QComboBox*>(getQWidget());
-    return qcombobox->itemText(index).toStdString();
+    if(index < 0 || index >= count()) return "";
+    return mirror_items[index];
 }
 
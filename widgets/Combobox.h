@@ -21,6 +21,10 @@ class Combobox : public Widget, public EventOnChangeInt
 protected:
     std::vector<std::string> items;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    std::vector<std::string> mirror_items;
+    int mirror_selectedIndex;
+
 public:
     Combobox();
     virtual ~Combobox();
@@ -30,10 +34,19 @@ public:
 
     void insertItem(int index, std::string text, bool suppressSignals);
     void removeItem(int index, bool suppressSignals);
-    void setItems(std::vector<std::string> items, int index, bool suppressSignals);
-    std::vector<std::string> getItems();
+    void setItems(const std::vector<std::string> &items, int index, bool suppressSignals);
     void setSelectedIndex(int index, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorInsertItem(int index, std::string text);
+    void mirrorRemoveItem(int index);
+    void mirrorItems(std::vector<std::string> items, int index);
+    void mirrorSelectedIndex(int index);
+    std::vector<std::string> getItems();
     int getSelectedIndex();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
+    void mirrorValueChange(int value);
     int count();
     std::string itemText(int index);
 
@@ -2,6 +2,7 @@
 
 #include "XMLUtils.h"
 
+#include "SIM.h"
 #include "UI.h"
 
 #include <QLineEdit>
@@ -26,6 +27,8 @@ void Edit::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLE
     onchange = xmlutils::getAttrStr(e, "on-change", "");
 
     oneditingfinished = xmlutils::getAttrStr(e, "on-editing-finished", "");
+
+    mirror_value = value;
 }
 
 QWidget * Edit::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -36,8 +39,8 @@ QWidget * Edit::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     edit->setStyleSheet(QString::fromStdString(style));
     edit->setText(QString::fromStdString(value));
     edit->setEchoMode(password ? QLineEdit::Password : QLineEdit::Normal);
-    QObject::connect(edit, &QLineEdit::textChanged, ui, &UI::onValueChangeString);
-    QObject::connect(edit, &QLineEdit::editingFinished, ui, &UI::onEditingFinished);
+    QObject::connect(edit, &QLineEdit::textChanged, ui, [=](const QString &text) {ui->onValueChangeString(this, text);});
+    QObject::connect(edit, &QLineEdit::editingFinished, ui, [=] {ui->onEditingFinished(this);});
     setQWidget(edit);
     setProxy(proxy);
     return edit;
@@ -51,9 +54,34 @@ void Edit::setValue(std::string value, bool suppressSignals)
     qedit->blockSignals(oldSignalsState);
 }
 
+void Edit::mirrorValue(std::string value)
+{
+    setterChangedMirror();
+    mirror_value = value;
+}
+
 std::string Edit::getValue()
 {
-    QLineEdit *qedit = static_cast<QLineEdit*>(getQWidget());
-    return qedit->text().toStdString();
+    return mirror_value;
+}
+
+bool Edit::getMirrorValue(widget_value &val)
+{
+    val.isText = true;
+    val.text = getValue();
+    return true;
+}
+
+bool Edit::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, true);
+    mirrorValue(val.text);
+    SIM::getInstance()->update(this, Property::Value, UI_SLOT(onSetEditValue), val.text, suppressEvents);
+    return true;
+}
+
+void Edit::mirrorValueChange(const std::string &value)
+{
+    mirror_value = value;
 }
 
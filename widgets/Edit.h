@@ -22,6 +22,9 @@ protected:
     std::string value;
     bool password;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    std::string mirror_value;
+
 public:
     Edit();
     virtual ~Edit();
@@ -30,7 +33,13 @@ public:
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
 
     void setValue(std::string value, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorValue(std::string value);
     std::string getValue();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
+    void mirrorValueChange(const std::string &value);
 
     friend class SIM;
 };
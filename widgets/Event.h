@@ -14,6 +14,7 @@ public:
     virtual ~Event();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnClick : public Event
@@ -26,6 +27,7 @@ public:
     virtual ~EventOnClick();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnChange : public Event
@@ -38,6 +40,7 @@ public:
     virtual ~EventOnChange();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnChangeInt : public EventOnChange
@@ -47,6 +50,7 @@ public:
     virtual ~EventOnChangeInt();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnChangeDouble : public EventOnChange
@@ -56,6 +60,7 @@ public:
     virtual ~EventOnChangeDouble();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnChangeString : public EventOnChange
@@ -65,6 +70,7 @@ public:
     virtual ~EventOnChangeString();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnEditingFinished : public Event
@@ -77,6 +83,7 @@ public:
     virtual ~EventOnEditingFinished();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnLinkActivated : public Event
@@ -89,6 +96,7 @@ public:
     virtual ~EventOnLinkActivated();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnKeyPress : public Event
@@ -101,6 +109,7 @@ public:
     virtual ~EventOnKeyPress();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnMouseDown : public Event
@@ -113,6 +122,7 @@ public:
     virtual ~EventOnMouseDown();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnMouseUp : public Event
@@ -125,6 +135,7 @@ public:
     virtual ~EventOnMouseUp();
 
     friend class SIM;
+    friend class Widget;
 };
 
 class EventOnMouseMove : public Event
@@ -137,6 +148,7 @@ public:
     virtual ~EventOnMouseMove();
 
     friend class SIM;
+    friend class Widget;
 };
 
 #endif // EVENT_H_INCLUDED
@@ -24,6 +24,16 @@ void Group::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XML
     LayoutWidget::parse(this, parent, widgets, e);
 }
 
+void Group::cloneChildren(std::map<int, Widget*>& widgets)
+{
+    LayoutWidget::cloneLayout(widgets);
+}
+
+void Group::replaceChildren(const std::unordered_map<Widget*, Widget*> &replacements)
+{
+    LayoutWidget::replaceInLayout(replacements);
+}
+
 QWidget * Group::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
 {
     QWidget *groupBox = flat ?
@@ -34,7 +44,12 @@ QWidget * Group::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     groupBox->setEnabled(enabled);
     groupBox->setVisible(visible);
     groupBox->setStyleSheet(QString::fromStdString(style));
-    LayoutWidget::createQtWidget(proxy, ui, groupBox);
+    // the contents of a hidden group are created when it is first shown (see
+    // UI::onSetWidgetVisibility):
+    if(visible)
+        LayoutWidget::createQtWidget(proxy, ui, groupBox);
+    else
+        LayoutWidget::createQtWidgetLazily(this, proxy, ui, groupBox);
     setQWidget(groupBox);
     setProxy(proxy);
     return groupBox;
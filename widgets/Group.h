@@ -27,6 +27,8 @@ public:
 
     void parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
+    void cloneChildren(std::map<int, Widget*>& widgets);
+    void replaceChildren(const std::unordered_map<Widget*, Widget*> &replacements);
 
     friend class SIM;
 };
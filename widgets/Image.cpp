@@ -54,7 +54,7 @@ QWidget * Image::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     }
     if(file != "")
     {
-        UI::getInstance()->loadImageFromFile(this, file.c_str(), width, height);
+        UI::getInstance()->loadImageFromFile(getRef(), file.c_str(), width, height);
     }
     QObject::connect(label, &QImageWidget::mouseEvent, ui, &UI::onMouseEvent);
     setQWidget(label);
@@ -62,13 +62,19 @@ QWidget * Image::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     return label;
 }
 
+ImageData makeImageData(char *buffer)
+{
+    // XXX: simReleaseBuffer should accept a const pointer?
+    return ImageData(buffer, [](const char *p) {sim::releaseBuffer(const_cast<char *>(p));});
+}
+
 void Image::setImage(const char *data, int w, int h)
 {
     if(!data) return;
     QImage::Format format = QImage::Format_RGB888;
     int bpp = 3; // bytes per pixel
+    // (fromImage makes a deep copy of data)
     QPixmap pixmap = QPixmap::fromImage(QImage((unsigned char *)data, w, h, bpp * w, format));
-    sim::releaseBuffer((char *)data); // XXX: simReleaseBuffer should accept a const pointer?
     QImageWidget *qimage = static_cast<QImageWidget*>(getQWidget());
     qimage->setPixmap(pixmap);
     qimage->resize(pixmap.size());
@@ -124,7 +130,7 @@ void QImageWidget::updateMargins()
 
 void QImageWidget::mouseMoveEvent(QMouseEvent *event)
 {
-    if(image->onMouseMove != "")
+    if(image->onMouseMove != "" || image->proxy->window->pollEvents)
     {
         event->accept();
         int type = sim_ui_mouse_move;
@@ -142,7 +148,7 @@ void QImageWidget::mouseMoveEvent(QMouseEvent *event)
 
 void QImageWidget::mousePressEvent(QMouseEvent *event)
 {
-    if(image->onMouseDown != "" && event->button() == Qt::LeftButton)
+    if((image->onMouseDown != "" || image->proxy->window->pollEvents) && event->button() == Qt::LeftButton)
     {
         event->accept();
         int type = sim_ui_mouse_left_button_down;
@@ -160,7 +166,7 @@ void QImageWidget::mousePressEvent(QMouseEvent *event)
 
 void QImageWidget::mouseReleaseEvent(QMouseEvent *event)
 {
-    if(image->onMouseUp != "" && event->button() == Qt::LeftButton)
+    if((image->onMouseUp != "" || image->proxy->window->pollEvents) && event->button() == Qt::LeftButton)
     {
         event->accept();
         int type = sim_ui_mouse_left_button_up;
@@ -3,6 +3,7 @@
 
 #include "config.h"
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -16,6 +17,13 @@ class UI;
 #include "Widget.h"
 #include "Event.h"
 
+// RGB888 image data allocated with sim::createBuffer (or returned by the sim
+// image functions), released with sim::releaseBuffer when no longer referenced;
+// this way, an image update which is dropped (see Property::Image) doesn't leak
+typedef std::shared_ptr<const char> ImageData;
+
+ImageData makeImageData(char *buffer);
+
 class Image : public Widget, public EventOnMouseDown, public EventOnMouseUp, public EventOnMouseMove
 {
 protected:
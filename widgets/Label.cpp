@@ -2,6 +2,7 @@
 
 #include "XMLUtils.h"
 
+#include "SIM.h"
 #include "UI.h"
 
 #include <QLabel>
@@ -24,6 +25,8 @@ void Label::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XML
     wordWrap = xmlutils::getAttrBool(e, "wordwrap", false);
 
     onLinkActivated = xmlutils::getAttrStr(e, "on-link-activated", "");
+
+    mirror_text = text;
 }
 
 QWidget * Label::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -34,7 +37,7 @@ QWidget * Label::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     label->setStyleSheet(QString::fromStdString(style));
     label->setWordWrap(wordWrap);
     label->setOpenExternalLinks(false);
-    QObject::connect(label, &QLabel::linkActivated, ui, &UI::onLinkActivated);
+    QObject::connect(label, &QLabel::linkActivated, ui, [=](const QString &link) {ui->onLinkActivated(this, link);});
     setQWidget(label);
     setProxy(proxy);
     return label;
@@ -48,9 +51,28 @@ void Label::setText(std::string text, bool suppressSignals)
     qlabel->blockSignals(oldSignalsState);
 }
 
+void Label::mirrorText(std::string text)
+{
+    mirror_text = text;
+}
+
 std::string Label::getText()
 {
-    QLabel *qlabel = static_cast<QLabel*>(getQWidget());
-    return qlabel->text().toStdString();
+    return mirror_text;
+}
+
+bool Label::getMirrorValue(widget_value &val)
+{
+    val.isText = true;
+    val.text = getText();
+    return true;
+}
+
+bool Label::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, true);
+    mirrorText(val.text);
+    SIM::getInstance()->update(this, Property::Text, UI_SLOT(onSetLabelText), val.text, suppressEvents);
+    return true;
 }
 
@@ -22,6 +22,9 @@ protected:
     std::string text;
     bool wordWrap;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    std::string mirror_text;
+
 public:
     Label();
     virtual ~Label();
@@ -30,7 +33,12 @@ public:
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
 
     void setText(std::string text, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorText(std::string text);
     std::string getText();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
 
     friend class SIM;
 };
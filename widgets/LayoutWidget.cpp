@@ -41,6 +41,13 @@ QWidget * Stretch::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     throw std::runtime_error("stretch can be used only in VBox/HBox layouts");
 }
 
+LayoutWidget::LayoutWidget()
+{
+    deferred.proxy = NULL;
+    deferred.ui = NULL;
+    deferred.parent = NULL;
+}
+
 LayoutWidget::~LayoutWidget()
 {
     for(std::vector< std::vector<Widget*> >::iterator it = children.begin(); it != children.end(); ++it)
@@ -116,6 +123,72 @@ void LayoutWidget::parse(Widget *self, Widget *parent, std::map<int, Widget*>& w
     }
 }
 
+void LayoutWidget::createQtWidgetLazily(Widget *self, Proxy *proxy, UI *ui, QWidget *parent)
+{
+    deferred.proxy = proxy;
+    deferred.ui = ui;
+    deferred.parent = parent;
+    proxy->addLazyWidget(self);
+}
+
+void LayoutWidget::materialize()
+{
+    if(!deferred.parent) return;
+
+    QWidget *parent = deferred.parent;
+    deferred.parent = NULL;
+    createQtWidget(deferred.proxy, deferred.ui, parent);
+    deferred.ui->runDeferredCommands();
+}
+
+void LayoutWidget::cloneLayout(std::map<int, Widget*>& widgets)
+{
+    std::vector< std::vector<Widget*> > prototypes;
+    prototypes.swap(children);
+    for(std::vector< std::vector<Widget*> >::const_iterator it = prototypes.begin(); it != prototypes.end(); ++it)
+    {
+        std::vector<Widget*> row;
+        try
+        {
+            for(std::vector<Widget*>::const_iterator it2 = it->begin(); it2 != it->end(); ++it2)
+                row.push_back(Widget::cloneAny(*it2, widgets));
+        }
+        catch(std::exception& ex)
+        {
+            children.push_back(row); // push widgets created until now so they won't leak
+            throw;
+        }
+        children.push_back(row);
+    }
+}
+
+void LayoutWidget::replaceInLayout(const std::unordered_map<Widget*, Widget*> &replacements)
+{
+    for(std::vector< std::vector<Widget*> >::iterator it = children.begin(); it != children.end(); ++it)
+    {
+        for(std::vector<Widget*>::iterator it2 = it->begin(); it2 != it->end(); ++it2)
+        {
+            auto r = replacements.find(*it2);
+            if(r != replacements.end())
+                *it2 = r->second;
+            else
+                (*it2)->replaceChildren(replacements);
+        }
+    }
+}
+
+QWidget * LayoutWidget::createChildQtWidget(Widget *w, Proxy *proxy, UI *ui, QWidget *parent)
+{
+    QWidget *qw = w->getQWidget();
+    if(!qw)
+        return w->createQtWidget(proxy, ui, parent);
+
+    // setParent() hides the widget:
+    qw->setParent(parent);
+    qw->setVisible(w->visible);
+    return qw;
+}
+
 void LayoutWidget::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
 {
     switch(layout)
@@ -137,7 +210,7 @@ void LayoutWidget::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
                     qlayout->addStretch(stretch->factor);
                     continue;
                 }
-                QWidget *qw = w->createQtWidget(proxy, ui, parent);
+                QWidget *qw = createChildQtWidget(w, proxy, ui, parent);
                 if(qlayout) qlayout->addWidget(qw);
                 if(layout == NONE && w->geometry.isSet)
                 {
@@ -159,7 +232,7 @@ void LayoutWidget::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
                 for(std::vector<Widget*>::iterator it2 = it->begin(); it2 != it->end(); ++it2)
                 {
                     Widget *w = *it2;
-                    QWidget *qw = w->createQtWidget(proxy, ui, parent);
+                    QWidget *qw = createChildQtWidget(w, proxy, ui, parent);
                     qlayout->addWidget(qw, row, col);
                     col++;
                 }
@@ -175,8 +248,8 @@ void LayoutWidget::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
             for(std::vector< std::vector<Widget*> >::iterator it = children.begin(); it != children.end(); ++it)
             {
                 Widget *w1 = (*it)[0], *w2 = (*it)[1];
-                QWidget *qw1 = w1->createQtWidget(proxy, ui, parent);
-                QWidget *qw2 = w2->createQtWidget(proxy, ui, parent);
+                QWidget *qw1 = createChildQtWidget(w1, proxy, ui, parent);
+                QWidget *qw2 = createChildQtWidget(w2, proxy, ui, parent);
                 qlayout->addRow(qw1, qw2);
             }
             parent->setLayout(qlayout);
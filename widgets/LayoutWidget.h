@@ -6,6 +6,7 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include <QWidget>
 
@@ -47,12 +48,42 @@ protected:
     std::array<int, 4> contentMargins;
     std::vector< std::vector<Widget*> > children;
 
+    // set if the creation of the children has been deferred (see
+    // createQtWidgetLazily):
+    struct
+    {
+        Proxy *proxy;
+        UI *ui;
+        QWidget *parent;
+    } deferred;
+
 public:
+    LayoutWidget();
     virtual ~LayoutWidget();
 
     void parse(Widget *self, Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
     void createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
 
+    // (UI thread) like createQtWidget, but the children are created only
+    // by materialize() (e.g. when a tab is shown for the first time); until
+    // then, their setters are deferred (see UI::runCommand):
+    void createQtWidgetLazily(Widget *self, Proxy *proxy, UI *ui, QWidget *parent);
+    void materialize();
+    inline bool isMaterialized() {return !deferred.parent;}
+
+    // replaces the children shared with the prototype with copies of them
+    // (see Widget::clone1):
+    void cloneLayout(std::map<int, Widget*>& widgets);
+
+    // replaces the children found in the given map, and looks for the
+    // others in the nested containers (see Window::updateStructure):
+    void replaceInLayout(const std::unordered_map<Widget*, Widget*> &replacements);
+
+private:
+    // creates the Qt widget of a child, or reparents it if it exists already
+    // (a widget kept by Window::updateStructure):
+    QWidget * createChildQtWidget(Widget *w, Proxy *proxy, UI *ui, QWidget *parent);
+
     friend class Stretch;
 };
 
@@ -4,6 +4,9 @@
 
 #include "UI.h"
 
+#include "Trace.h"
+
+#include <algorithm>
 #include <stdexcept>
 
 #include <boost/foreach.hpp>
@@ -92,7 +95,7 @@ QWidget * Plot::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
         bgcol = toQColor(background_color);
     plot->setBackground(QBrush(bgcol));
     plot->setInteraction(QCP::iSelectPlottables);
-    if(onLegendClick != "")
+    if(onLegendClick != "" || proxy->window->pollEvents)
         plot->setInteraction(QCP::iSelectLegend);
     plot->legend->setSelectableParts(QCPLegend::spItems);
     plot->setAutoAddPlottableToLegend(false);
@@ -166,8 +169,8 @@ QWidget * Plot::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     plot->xAxis->setTickLabels(x_tick_labels);
     plot->yAxis->setTickLabels(y_tick_labels);
     plot->setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Expanding);
-    QObject::connect(plot, &MyCustomPlot::plottableClick, ui, &UI::onPlottableClick);
-    QObject::connect(plot, &MyCustomPlot::legendClick, ui, &UI::onLegendClick);
+    QObject::connect(plot, &MyCustomPlot::plottableClick, ui, [=](QCPAbstractPlottable *plottable, int index, QMouseEvent *event) {ui->onPlottableClick(this, plottable, index, event);});
+    QObject::connect(plot, &MyCustomPlot::legendClick, ui, [=](QCPLegend *legend, QCPAbstractLegendItem *item, QMouseEvent *event) {ui->onLegendClick(this, legend, item, event);});
     setQWidget(plot);
     setProxy(proxy);
     return plot;
@@ -427,11 +430,24 @@ void Plot::addTimeData(std::string name, const std::vector<double>& x, const std
 
     if(!cyclic_buffer && max_buffer_size > 0 && curve->dataCount() >= max_buffer_size) return;
 
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-    curve->addData(QVector<double>::fromStdVector(x), QVector<double>::fromStdVector(y));
-#else
-    curve->addData(QVector<double>(x.begin(), x.end()), QVector<double>(y.begin(), y.end()));
-#endif
+    // the points are appended directly to the data container, without the
+    // intermediate QVectors of QCPGraph::addData (if they are sorted, and
+    // come after the existing ones, they are just appended):
+    QSharedPointer<QCPGraphDataContainer> data = curve->data();
+    std::size_t n = std::min(x.size(), y.size());
+    bool sorted = std::is_sorted(x.begin(), x.begin() + n) && (data->isEmpty() || n == 0 || x[0] >= (data->constEnd() - 1)->key);
+    if(sorted)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            data->add(QCPGraphData(x[i], y[i]));
+    }
+    else
+    {
+        QVector<QCPGraphData> points(n);
+        for(std::size_t i = 0; i < n; i++)
+            points[i] = QCPGraphData(x[i], y[i]);
+        data->add(points, false);
+    }
 
     if(max_buffer_size > 0)
     {
@@ -457,11 +473,22 @@ void Plot::addXYData(std::string name, const std::vector<double>& t, const std::
 
     if(!cyclic_buffer && max_buffer_size > 0 && curve->dataCount() >= max_buffer_size) return;
 
-#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
-    curve->addData(QVector<double>::fromStdVector(t), QVector<double>::fromStdVector(x), QVector<double>::fromStdVector(y));
-#else
-    curve->addData(QVector<double>(t.begin(), t.end()), QVector<double>(x.begin(), x.end()), QVector<double>(y.begin(), y.end()));
-#endif
+    // see addTimeData:
+    QSharedPointer<QCPCurveDataContainer> data = curve->data();
+    std::size_t n = std::min(t.size(), std::min(x.size(), y.size()));
+    bool sorted = std::is_sorted(t.begin(), t.begin() + n) && (data->isEmpty() || n == 0 || t[0] >= (data->constEnd() - 1)->t);
+    if(sorted)
+    {
+        for(std::size_t i = 0; i < n; i++)
+            data->add(QCPCurveData(t[i], x[i], y[i]));
+    }
+    else
+    {
+        QVector<QCPCurveData> points(n);
+        for(std::size_t i = 0; i < n; i++)
+            points[i] = QCPCurveData(t[i], x[i], y[i]);
+        data->add(points, false);
+    }
 
     if(max_buffer_size > 0)
     {
@@ -650,6 +677,8 @@ MyCustomPlot::MyCustomPlot(Plot *plot, QWidget *parent) : QCustomPlot(parent), p
 {
     QObject::connect(this, &MyCustomPlot::mousePress, this, &MyCustomPlot::onMousePress);
     QObject::connect(this, &MyCustomPlot::mouseMove, this, &MyCustomPlot::onMouseMove);
+    QObject::connect(this, &MyCustomPlot::beforeReplot, this, &MyCustomPlot::onBeforeReplot);
+    QObject::connect(this, &MyCustomPlot::afterReplot, this, &MyCustomPlot::onAfterReplot);
 }
 
 void MyCustomPlot::mouseDoubleClickEvent(QMouseEvent *event)
@@ -688,3 +717,12 @@ void MyCustomPlot::onMouseMove(QMouseEvent *event)
     }
 }
 
+void MyCustomPlot::onBeforeReplot()
+{
+    replotStart = std::chrono::steady_clock::now();
+}
+
+void MyCustomPlot::onAfterReplot()
+{
+    Trace::complete("replot", "replot", replotStart, std::chrono::steady_clock::now());
+}
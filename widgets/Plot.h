@@ -3,6 +3,7 @@
 
 #include "config.h"
 
+#include <chrono>
 #include <vector>
 #include <map>
 #include <string>
@@ -112,6 +113,8 @@ class MyCustomPlot : public QCustomPlot
     Q_OBJECT
 private:
     Plot *plot_;
+    // start of the current replot, for the trace (see Trace):
+    std::chrono::steady_clock::time_point replotStart;
 public:
     MyCustomPlot(Plot *plot, QWidget *parent);
     void mouseDoubleClickEvent(QMouseEvent *event);
@@ -119,6 +122,8 @@ public:
 private slots:
     void onMousePress(QMouseEvent *event);
     void onMouseMove(QMouseEvent *event);
+    void onBeforeReplot();
+    void onAfterReplot();
 };
 
 #endif // PLOT_H_INCLUDED
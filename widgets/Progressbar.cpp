@@ -2,6 +2,7 @@
 
 #include "XMLUtils.h"
 
+#include "SIM.h"
 #include "UI.h"
 
 #include <QProgressBar>
@@ -33,6 +34,8 @@ void Progressbar::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml
     value = xmlutils::getAttrInt(e, "value", 0);
 
     text_visible = xmlutils::getAttrBool(e, "text-visible", true);
+
+    mirror_value = value;
 }
 
 QWidget * Progressbar::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -58,3 +61,29 @@ void Progressbar::setValue(int value)
     progressbar->setValue(value);
 }
 
+void Progressbar::mirrorValue(int value)
+{
+    // same as QProgressBar, which ignores values out of range:
+    if(value >= minimum && value <= maximum)
+        mirror_value = value;
+}
+
+int Progressbar::getValue()
+{
+    return mirror_value;
+}
+
+bool Progressbar::getMirrorValue(widget_value &val)
+{
+    val.number = getValue();
+    return true;
+}
+
+bool Progressbar::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, false);
+    mirrorValue(int(val.number));
+    SIM::getInstance()->update(this, Property::Value, UI_SLOT(onSetProgress), int(val.number));
+    return true;
+}
+
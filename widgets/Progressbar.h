@@ -25,6 +25,9 @@ protected:
     int value;
     bool text_visible;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    int mirror_value;
+
 public:
     Progressbar();
     virtual ~Progressbar();
@@ -33,6 +36,12 @@ public:
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
     void setValue(int value);
 
+    // (SIM thread) mirrored state:
+    void mirrorValue(int value);
+    int getValue();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
+
     friend class SIM;
 };
 
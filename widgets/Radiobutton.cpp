@@ -2,6 +2,7 @@
 
 #include "XMLUtils.h"
 
+#include "SIM.h"
 #include "UI.h"
 
 #include <QRadioButton>
@@ -28,6 +29,9 @@ void Radiobutton::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml
     auto_exclusive = xmlutils::getAttrBool(e, "auto-exclusive", true);
 
     onclick = xmlutils::getAttrStr(e, "on-click", "");
+
+    // (other buttons of the same group are mirrored by the toggled signal)
+    mirror_checked = checked && checkable;
 }
 
 QWidget * Radiobutton::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -39,7 +43,10 @@ QWidget * Radiobutton::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     button->setCheckable(checkable);
     button->setAutoExclusive(auto_exclusive);
     button->setChecked(checked);
-    QObject::connect(button, &QRadioButton::released, ui, &UI::onButtonClick);
+    QObject::connect(button, &QRadioButton::released, ui, [=] {ui->onButtonClick(this);});
+    // not an event for the script, but needed to mirror the state changes
+    // caused by other buttons of the same group:
+    QObject::connect(button, &QRadioButton::toggled, ui, [=](bool checked) {ui->onMirrorChangeInt(this, checked);});
     setQWidget(button);
     setProxy(proxy);
     return button;
@@ -68,9 +75,34 @@ void Radiobutton::setValue(bool value, bool suppressSignals)
     qradiobutton->blockSignals(oldSignalsState);
 }
 
+void Radiobutton::mirrorValue(bool value)
+{
+    setterChangedMirror();
+    mirror_checked = value;
+}
+
 bool Radiobutton::getValue()
 {
-    QRadioButton *qradiobutton = static_cast<QRadioButton*>(getQWidget());
-    return qradiobutton->isChecked();
+    return mirror_checked;
+}
+
+bool Radiobutton::getMirrorValue(widget_value &val)
+{
+    val.number = convertValueToInt(getValue());
+    return true;
+}
+
+bool Radiobutton::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, false);
+    bool v = convertValueFromInt(int(val.number));
+    mirrorValue(v);
+    SIM::getInstance()->call(this, UI_SLOT(onSetRadiobuttonValue), v, suppressEvents);
+    return true;
+}
+
+void Radiobutton::mirrorValueChange(int value)
+{
+    mirror_checked = value != 0;
 }
 
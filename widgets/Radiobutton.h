@@ -24,6 +24,9 @@ protected:
     bool checkable;
     bool auto_exclusive;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    bool mirror_checked;
+
 public:
     Radiobutton();
     virtual ~Radiobutton();
@@ -34,7 +37,13 @@ public:
     bool convertValueFromInt(int value);
     int convertValueToInt(bool value);
     void setValue(bool value, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorValue(bool value);
     bool getValue();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
+    void mirrorValueChange(int value);
 
     friend class SIM;
 };
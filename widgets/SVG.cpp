@@ -76,7 +76,7 @@ SvgWidget::SvgWidget(QWidget *parent, SVG *svg_)
 
 void SvgWidget::mouseMoveEvent(QMouseEvent *event)
 {
-    if(svg->onMouseMove != "")
+    if(svg->onMouseMove != "" || svg->proxy->window->pollEvents)
     {
         event->accept();
         int type = sim_ui_mouse_move;
@@ -94,7 +94,7 @@ void SvgWidget::mouseMoveEvent(QMouseEvent *event)
 
 void SvgWidget::mousePressEvent(QMouseEvent *event)
 {
-    if(svg->onMouseDown != "" && event->button() == Qt::LeftButton)
+    if((svg->onMouseDown != "" || svg->proxy->window->pollEvents) && event->button() == Qt::LeftButton)
     {
         event->accept();
         int type = sim_ui_mouse_left_button_down;
@@ -112,7 +112,7 @@ void SvgWidget::mousePressEvent(QMouseEvent *event)
 
 void SvgWidget::mouseReleaseEvent(QMouseEvent *event)
 {
-    if(svg->onMouseUp != "" && event->button() == Qt::LeftButton)
+    if((svg->onMouseUp != "" || svg->proxy->window->pollEvents) && event->button() == Qt::LeftButton)
     {
         event->accept();
         int type = sim_ui_mouse_left_button_up;
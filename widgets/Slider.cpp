@@ -2,10 +2,12 @@
 
 #include "XMLUtils.h"
 
+#include "SIM.h"
 #include "UI.h"
 
 #include <QSlider>
 
+#include <algorithm>
 #include <stdexcept>
 #include <sstream>
 
@@ -47,6 +49,8 @@ void Slider::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XM
     inverted = xmlutils::getAttrBool(e, "inverted", false);
 
     onchange = xmlutils::getAttrStr(e, "on-change", "");
+
+    mirrorValue(value);
 }
 
 QWidget * Slider::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -55,13 +59,13 @@ QWidget * Slider::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     slider->setEnabled(enabled);
     slider->setVisible(visible);
     slider->setStyleSheet(QString::fromStdString(style));
-    slider->setValue(value);
     slider->setMinimum(minimum);
     slider->setMaximum(maximum);
+    slider->setValue(value);
     slider->setTickPosition(tickPosition);
     slider->setTickInterval(tickInterval);
     slider->setInvertedAppearance(inverted);
-    QObject::connect(slider, &QSlider::valueChanged, ui, &UI::onValueChangeInt);
+    QObject::connect(slider, &QSlider::valueChanged, ui, [=](int value) {ui->onValueChangeInt(this, value);});
     setQWidget(slider);
     setProxy(proxy);
     return slider;
@@ -75,9 +79,33 @@ void Slider::setValue(int value, bool suppressSignals)
     qslider->blockSignals(oldSignalsState);
 }
 
+void Slider::mirrorValue(int value)
+{
+    setterChangedMirror();
+    mirror_value = std::min(std::max(value, minimum), maximum);
+}
+
 int Slider::getValue()
 {
-    QSlider *qslider = static_cast<QSlider*>(getQWidget());
-    return qslider->value();
+    return mirror_value;
+}
+
+bool Slider::getMirrorValue(widget_value &val)
+{
+    val.number = getValue();
+    return true;
+}
+
+bool Slider::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, false);
+    mirrorValue(int(val.number));
+    SIM::getInstance()->update(this, Property::Value, UI_SLOT(onSetSliderValue), int(val.number), suppressEvents);
+    return true;
+}
+
+void Slider::mirrorValueChange(int value)
+{
+    mirror_value = value;
 }
 
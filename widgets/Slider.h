@@ -27,6 +27,9 @@ protected:
     QSlider::TickPosition tickPosition;
     bool inverted;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    int mirror_value;
+
     virtual Qt::Orientation getOrientation() = 0;
 
 public:
@@ -37,7 +40,13 @@ public:
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
 
     void setValue(int value, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorValue(int value);
     int getValue();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
+    void mirrorValueChange(int value);
 
     friend class SIM;
 };
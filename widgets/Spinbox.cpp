@@ -3,8 +3,10 @@
 #include "XSpinBox/xspinbox.h"
 
 #include "XMLUtils.h"
+#include "SIM.h"
 #include "UI.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include <QSpinBox>
@@ -45,6 +47,8 @@ void Spinbox::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::X
 
     bool detectedFloat = isFloat(minimum) || isFloat(maximum) || isFloat(step) || decimals > -1;
     float_ = xmlutils::getAttrBool(e, "float", detectedFloat);
+
+    mirrorValue(value);
 }
 
 QWidget * Spinbox::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -55,14 +59,15 @@ QWidget * Spinbox::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
         spinbox->setEnabled(enabled);
         spinbox->setVisible(visible);
         spinbox->setStyleSheet(QString::fromStdString(style));
-        spinbox->setValue(value);
+        // (range and decimals first, as they adjust the value)
+        spinbox->setDecimals(decimals > -1 ? decimals : 6);
         spinbox->setMinimum(minimum);
         spinbox->setMaximum(maximum);
+        spinbox->setValue(value);
         spinbox->setPrefix(QString::fromStdString(prefix));
         spinbox->setSuffix(QString::fromStdString(suffix));
         spinbox->setSingleStep(step);
-        spinbox->setDecimals(decimals > -1 ? decimals : 6);
-        QObject::connect(spinbox, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), ui, &UI::onValueChangeDouble);
+        QObject::connect(spinbox, static_cast<void (QDoubleSpinBox::*)(double)>(&QDoubleSpinBox::valueChanged), ui, [=](double value) {ui->onValueChangeDouble(this, value);});
         setQWidget(spinbox);
         setProxy(proxy);
         return spinbox;
@@ -73,13 +78,13 @@ QWidget * Spinbox::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
         spinbox->setEnabled(enabled);
         spinbox->setVisible(visible);
         spinbox->setStyleSheet(QString::fromStdString(style));
-        spinbox->setValue(int(value));
         spinbox->setMinimum(int(minimum));
         spinbox->setMaximum(int(maximum));
+        spinbox->setValue(int(value));
         spinbox->setPrefix(QString::fromStdString(prefix));
         spinbox->setSuffix(QString::fromStdString(suffix));
         spinbox->setSingleStep(int(step));
-        QObject::connect(spinbox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), ui, &UI::onValueChangeInt);
+        QObject::connect(spinbox, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), ui, [=](int value) {ui->onValueChangeInt(this, value);});
         setQWidget(spinbox);
         setProxy(proxy);
         return spinbox;
@@ -101,19 +106,48 @@ void Spinbox::setValue(double value, bool suppressSignals)
     qwidget->blockSignals(oldSignalsState);
 }
 
-double Spinbox::getValue()
+void Spinbox::mirrorValue(double value)
 {
-    if(QSpinBox *spinbox = dynamic_cast<QSpinBox*>(getQWidget()))
-    {
-        return spinbox->value();
-    }
-    else if(QDoubleSpinBox *doubleSpinbox = dynamic_cast<QDoubleSpinBox*>(getQWidget()))
+    setterChangedMirror();
+    // same adjustments done by QSpinBox/QDoubleSpinBox:
+    if(float_)
     {
-        return doubleSpinbox->value();
+        double k = std::pow(10.0, decimals > -1 ? decimals : 6);
+        value = std::round(value * k) / k;
+        mirror_value = std::min(std::max(value, minimum), maximum);
     }
     else
     {
-        return NAN;
+        mirror_value = std::min(std::max(int(value), int(minimum)), int(maximum));
     }
 }
 
+double Spinbox::getValue()
+{
+    return mirror_value;
+}
+
+bool Spinbox::getMirrorValue(widget_value &val)
+{
+    val.number = getValue();
+    return true;
+}
+
+bool Spinbox::setMirrorValue(const widget_value &val, bool suppressEvents)
+{
+    checkValueType(val, false);
+    mirrorValue(val.number);
+    SIM::getInstance()->update(this, Property::Value, UI_SLOT(onSetSpinboxValue), val.number, suppressEvents);
+    return true;
+}
+
+void Spinbox::mirrorValueChange(int value)
+{
+    mirror_value = value;
+}
+
+void Spinbox::mirrorValueChange(double value)
+{
+    mirror_value = value;
+}
+
@@ -28,6 +28,9 @@ protected:
     int decimals;
     bool float_;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    double mirror_value;
+
 public:
     Spinbox();
     virtual ~Spinbox();
@@ -36,7 +39,14 @@ public:
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
 
     void setValue(double value, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorValue(double value);
     double getValue();
+    bool getMirrorValue(widget_value &val);
+    bool setMirrorValue(const widget_value &val, bool suppressEvents);
+    void mirrorValueChange(int value);
+    void mirrorValueChange(double value);
 
     friend class SIM;
 };
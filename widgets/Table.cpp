@@ -81,6 +81,11 @@ void Table::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XML
     else throw std::range_error("selection-mode must be one of: 'item', 'row', 'column'");
 
     onKeyPress = xmlutils::getAttrStr(e, "on-key-press", "");
+
+    mirror_rowCount = rows.size();
+    mirror_columnCount = 0;
+    for(size_t i = 0; i < rows.size(); i++)
+        mirror_columnCount = std::max(mirror_columnCount, int(rows[i].size()));
 }
 
 QWidget * Table::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -126,9 +131,9 @@ QWidget * Table::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     }
     tablewidget->setSelectionBehavior(selectionBehavior);
     tablewidget->setSelectionMode(selectionMode);
-    QObject::connect(tablewidget, &QTableWidget::cellActivated, ui, &UI::onCellActivate);
-    QObject::connect(tablewidget, &QTableWidget::cellChanged, ui, &UI::onCellActivate);
-    QObject::connect(tablewidget, &QTableWidget::itemSelectionChanged, ui, &UI::onTableSelectionChange);
+    QObject::connect(tablewidget, &QTableWidget::cellActivated, ui, [=](int row, int col) {ui->onCellActivate(this, row, col);});
+    QObject::connect(tablewidget, &QTableWidget::cellChanged, ui, [=](int row, int col) {ui->onCellActivate(this, row, col);});
+    QObject::connect(tablewidget, &QTableWidget::itemSelectionChanged, ui, [=] {ui->onTableSelectionChange(this);});
     setQWidget(tablewidget);
     setEditable(editable);
     setProxy(proxy);
@@ -183,7 +188,7 @@ void Table::setItem(int row, int column, std::string text, bool suppressSignals)
     tablewidget->blockSignals(oldSignalsState);
 }
 
-void Table::setItemImage(int row, int column, std::string data, int width, int height, bool suppressSignals)
+void Table::setItemImage(int row, int column, const std::string &data, int width, int height, bool suppressSignals)
 {
     QTableWidget *tablewidget = static_cast<QTableWidget*>(getQWidget());
     bool oldSignalsState = tablewidget->blockSignals(suppressSignals);
@@ -197,16 +202,25 @@ void Table::setItemImage(int row, int column, std::string data, int width, int h
     tablewidget->blockSignals(oldSignalsState);
 }
 
+void Table::mirrorRowCount(int count)
+{
+    // QTableWidget ignores a negative count:
+    if(count >= 0) mirror_rowCount = count;
+}
+
+void Table::mirrorColumnCount(int count)
+{
+    if(count >= 0) mirror_columnCount = count;
+}
+
 int Table::getRowCount()
 {
-    QTableWidget *tablewidget = static_cast<QTableWidget*>(getQWidget());
-    return tablewidget->rowCount();
+    return mirror_rowCount;
 }
 
 int Table::getColumnCount()
 {
-    QTableWidget *tablewidget = static_cast<QTableWidget*>(getQWidget());
-    return tablewidget->columnCount();
+    return mirror_columnCount;
 }
 
 std::string Table::getItem(int row, int column)
@@ -291,7 +305,7 @@ TableWidget::TableWidget(Table *table_, QWidget *parent)
 
 void TableWidget::keyPressEvent(QKeyEvent *event)
 {
-    UI::getInstance()->keyPressed(table, event->key(), event->text().toStdString());
+    UI::getInstance()->keyPressed(table->getRef(), event->key(), event->text().toStdString());
     QTableWidget::keyPressEvent(event);
 }
 
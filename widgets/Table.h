@@ -42,6 +42,10 @@ protected:
     std::string onCellActivate;
     std::string onSelectionChange;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    int mirror_rowCount;
+    int mirror_columnCount;
+
 public:
     Table();
     virtual ~Table();
@@ -53,9 +57,14 @@ public:
     void setRowCount(int count, bool suppressSignals);
     void setColumnCount(int count, bool suppressSignals);
     void setItem(int row, int column, std::string text, bool suppressSignals);
-    void setItemImage(int row, int column, std::string data, int width, int height, bool suppressSignals);
+    void setItemImage(int row, int column, const std::string &data, int width, int height, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorRowCount(int count);
+    void mirrorColumnCount(int count);
     int getRowCount();
     int getColumnCount();
+
     std::string getItem(int row, int column);
     void setRowHeaderText(int row, std::string text);
     void setColumnHeaderText(int column, std::string text);
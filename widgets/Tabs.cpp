@@ -30,13 +30,31 @@ void Tab::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLEl
     LayoutWidget::parse(this, parent, widgets, e);
 }
 
+void Tab::cloneChildren(std::map<int, Widget*>& widgets)
+{
+    LayoutWidget::cloneLayout(widgets);
+}
+
+void Tab::replaceChildren(const std::unordered_map<Widget*, Widget*> &replacements)
+{
+    LayoutWidget::replaceInLayout(replacements);
+}
+
 QWidget * Tab::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
+{
+    return createQtWidget(proxy, ui, parent, false);
+}
+
+QWidget * Tab::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent, bool lazy)
 {
     QWidget *tab = new QWidget(parent);
     tab->setEnabled(enabled);
     tab->setVisible(visible);
     tab->setStyleSheet(QString::fromStdString(style));
-    LayoutWidget::createQtWidget(proxy, ui, tab);
+    if(lazy)
+        LayoutWidget::createQtWidgetLazily(this, proxy, ui, tab);
+    else
+        LayoutWidget::createQtWidget(proxy, ui, tab);
     setQWidget(tab);
     setProxy(proxy);
     return tab;
@@ -65,6 +83,23 @@ void Tabs::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLE
         if(tab)
             tabs.push_back(tab);
     }
+
+    mirror_currentIndex = tabs.empty() ? -1 : 0;
+}
+
+void Tabs::cloneChildren(std::map<int, Widget*>& widgets)
+{
+    std::vector<Tab*> prototypes;
+    prototypes.swap(tabs);
+    for(std::vector<Tab*>::const_iterator it = prototypes.begin(); it != prototypes.end(); ++it)
+        tabs.push_back(Widget::clone1(*it, widgets));
+}
+
+void Tabs::replaceChildren(const std::unordered_map<Widget*, Widget*> &replacements)
+{
+    // tabs are containers, so they are never replaced themselves:
+    for(std::vector<Tab*>::const_iterator it = tabs.begin(); it != tabs.end(); ++it)
+        (*it)->replaceChildren(replacements);
 }
 
 QWidget * Tabs::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -75,9 +110,14 @@ QWidget * Tabs::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     tabwidget->setStyleSheet(QString::fromStdString(style));
     for(std::vector<Tab*>::const_iterator it = tabs.begin(); it != tabs.end(); ++it)
     {
-        QWidget *tab = (*it)->createQtWidget(proxy, ui, tabwidget);
+        // the contents of the tabs other than the first one (the current
+        // one) are created when they are first shown:
+        QWidget *tab = (*it)->createQtWidget(proxy, ui, tabwidget, it != tabs.begin());
         tabwidget->addTab(tab, QString::fromStdString((*it)->title));
     }
+    QObject::connect(tabwidget, &QTabWidget::currentChanged, ui, [=](int index) {if(index >= 0 && index < int(tabs.size())) tabs[index]->materialize();});
+    // not an event for the script, but needed to mirror the current tab:
+    QObject::connect(tabwidget, &QTabWidget::currentChanged, ui, [=](int index) {ui->onMirrorChangeInt(this, index);});
     setQWidget(tabwidget);
     setProxy(proxy);
     return tabwidget;
@@ -86,14 +126,29 @@ QWidget * Tabs::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
 void Tabs::setCurrentTab(int index, bool suppressSignals)
 {
     QTabWidget *qtabwidget = static_cast<QTabWidget*>(getQWidget());
+    // currentChanged may be blocked:
+    if(index >= 0 && index < int(tabs.size()))
+        tabs[index]->materialize();
     bool oldSignalsState = qtabwidget->blockSignals(suppressSignals);
     qtabwidget->setCurrentIndex(index);
     qtabwidget->blockSignals(oldSignalsState);
 }
 
+void Tabs::mirrorCurrentTab(int index)
+{
+    setterChangedMirror();
+    // QTabWidget ignores an invalid index:
+    if(index >= 0 && index < int(tabs.size()))
+        mirror_currentIndex = index;
+}
+
 int Tabs::getCurrentTab()
 {
-    QTabWidget *qtabwidget = static_cast<QTabWidget*>(getQWidget());
-    return qtabwidget->currentIndex();
+    return mirror_currentIndex;
+}
+
+void Tabs::mirrorValueChange(int value)
+{
+    mirror_currentIndex = value;
 }
 
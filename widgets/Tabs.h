@@ -27,6 +27,9 @@ public:
 
     void parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
+    QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent, bool lazy);
+    void cloneChildren(std::map<int, Widget*>& widgets);
+    void replaceChildren(const std::unordered_map<Widget*, Widget*> &replacements);
 
     friend class Tabs;
 };
@@ -36,15 +39,24 @@ class Tabs : public Widget
 protected:
     std::vector<Tab*> tabs;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    int mirror_currentIndex;
+
 public:
     Tabs();
     virtual ~Tabs();
 
     void parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
+    void cloneChildren(std::map<int, Widget*>& widgets);
+    void replaceChildren(const std::unordered_map<Widget*, Widget*> &replacements);
 
     void setCurrentTab(int index, bool suppressSignals);
+
+    // (SIM thread) mirrored state:
+    void mirrorCurrentTab(int index);
     int getCurrentTab();
+    void mirrorValueChange(int value);
 
     friend class SIM;
 };
@@ -42,8 +42,8 @@ QWidget * TextBrowser::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
         qtextbrowser->setPlainText(QString::fromStdString(text));
     qtextbrowser->setReadOnly(read_only);
     qtextbrowser->setOpenLinks(false);
-    QObject::connect(qtextbrowser, &QTextBrowser::textChanged, ui, &UI::onTextChanged);
-    QObject::connect(qtextbrowser, &QTextBrowser::anchorClicked, ui, &UI::onAnchorClicked);
+    QObject::connect(qtextbrowser, &QTextBrowser::textChanged, ui, [=] {ui->onTextChanged(this);});
+    QObject::connect(qtextbrowser, &QTextBrowser::anchorClicked, ui, [=](const QUrl &link) {ui->onAnchorClicked(this, link);});
     setQWidget(qtextbrowser);
     setProxy(proxy);
     return qtextbrowser;
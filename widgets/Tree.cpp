@@ -142,7 +142,7 @@ QWidget * Tree::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     }
     populateItems(treewidget, by_parent, 0, treewidget->invisibleRootItem());
     treewidget->setColumnCount(columncount);
-    QObject::connect(treewidget, &QTreeWidget::itemSelectionChanged, ui, &UI::onTreeSelectionChange);
+    QObject::connect(treewidget, &QTreeWidget::itemSelectionChanged, ui, [=] {ui->onTreeSelectionChange(this);});
     setQWidget(treewidget);
     setProxy(proxy);
     return treewidget;
@@ -2,15 +2,18 @@
 
 #include "UI.h"
 
-#include <boost/format.hpp>
+#include <algorithm>
 
-std::map<QWidget *, Widget *> Widget::widgetByQWidget;
-std::set<Widget *> Widget::widgets;
+#include <boost/format.hpp>
 
 Widget::Widget(std::string widgetClass_)
     : qwidget(NULL),
       proxy(NULL),
-      widgetClass(widgetClass_)
+      widgetClass(widgetClass_),
+      ref(0),
+      container(false),
+      mirrorSeq(0),
+      appliedMirrorSeq(0)
 {
     // don't do this here because id is set by user:
     // Widget::widgets[id] = this;
@@ -20,7 +23,7 @@ Widget::Widget(std::string widgetClass_)
 
 Widget::~Widget()
 {
-    Widget::widgets.erase(this);
+    releaseSlot();
 
     sim::addLog(sim_verbosity_debug, "%s this=%x, id=%d, widgetClass=%s", __FUNC__, this, id, widgetClass);
 
@@ -31,29 +34,88 @@ Widget::~Widget()
         //sim::addLog(sim_verbosity_debug, this << "  delete 'qwidget' member (deleteLater())");
 
         //qwidget->deleteLater();
-
-        Widget::widgetByQWidget.erase(qwidget);
     }
 
-    if(proxy)
+    // (the id may belong to another widget already, see Window::updateStructure)
+    if(proxy && proxy->widgets.find(id) == this)
     {
         proxy->widgets.erase(id);
     }
 }
 
+void Widget::acquireSlot()
+{
+    ref = SlotTable<Widget>::acquire(this);
+}
+
+void Widget::releaseSlot()
+{
+    SlotTable<Widget>::release(ref);
+    ref = 0;
+}
+
+void Widget::initClone(std::map<int, Widget*>& widgets)
+{
+    // the copy is a new widget, which has not been created yet:
+    qwidget = NULL;
+    proxy = NULL;
+    ref = 0;
+    cloneChildren(widgets);
+    acquireSlot();
+    widgets[id] = this;
+}
+
 void Widget::setQWidget(QWidget *qwidget_)
 {
     if(qwidget)
         throw std::runtime_error("qwidget has been already set");
 
     qwidget = qwidget_;
-    Widget::widgetByQWidget[qwidget] = this;
+    // (see byQWidget)
+    qwidget->setProperty("simUI.ref", ref);
 }
 
 void Widget::setProxy(Proxy *proxy_)
 {
     proxy = proxy_;
-    proxy->widgets[id] = this;
+    proxy->widgets.insert(id, this);
+    resolveEventHandlers();
+}
+
+template<typename E>
+static const std::string * eventHandler(Widget *widget, std::string E::*callback)
+{
+    E *e = dynamic_cast<E*>(widget);
+    if(!e || e->*callback == "") return NULL;
+    return &(e->*callback);
+}
+
+void Widget::resolveEventHandlers()
+{
+    handlers.scriptID = proxy->getScriptID();
+    if(handlers.scriptID == -1)
+    {
+        handlers.onclick = handlers.onchange = handlers.oneditingfinished = handlers.onLinkActivated = handlers.onKeyPress = NULL;
+        handlers.onMouseDown = handlers.onMouseUp = handlers.onMouseMove = NULL;
+        return;
+    }
+
+    handlers.onclick = eventHandler(this, &EventOnClick::onclick);
+    // (a spinbox with float="false" emits integer value changes, so the
+    // handler is not tied to the type of the value)
+    handlers.onchange = eventHandler(this, &EventOnChange::onchange);
+    handlers.oneditingfinished = eventHandler(this, &EventOnEditingFinished::oneditingfinished);
+    handlers.onLinkActivated = eventHandler(this, &EventOnLinkActivated::onLinkActivated);
+    handlers.onKeyPress = eventHandler(this, &EventOnKeyPress::onKeyPress);
+    handlers.onMouseDown = eventHandler(this, &EventOnMouseDown::onMouseDown);
+    handlers.onMouseUp = eventHandler(this, &EventOnMouseUp::onMouseUp);
+    handlers.onMouseMove = eventHandler(this, &EventOnMouseMove::onMouseMove);
+}
+
+void Widget::checkValueType(const widget_value &val, bool isText)
+{
+    if(val.isText != isText)
+        throw std::runtime_error((boost::format("widget id %d: value must be a %s") % id % (isText ? "string" : "number")).str());
 }
 
 Widget * Widget::byId(const std::string &handle, int id, const sim::Handles<Proxy> &handles)
@@ -64,79 +126,104 @@ Widget * Widget::byId(const std::string &handle, int id, const sim::Handles<Prox
 
 Widget * Widget::byQWidget(QWidget *w)
 {
-    std::map<QWidget*, Widget*>::const_iterator it = Widget::widgetByQWidget.find(w);
-    Widget *ret = it == Widget::widgetByQWidget.end() ? NULL : it->second;
-    return ret;
+    if(!w) return NULL;
+    QVariant ref = w->property("simUI.ref");
+    return ref.isValid() ? byRef(ref.value<WidgetRef>()) : NULL;
 }
 
-bool Widget::exists(Widget *w)
+Widget * Widget::byRef(WidgetRef ref)
 {
-    return Widget::widgets.find(w) != Widget::widgets.end();
+    return SlotTable<Widget>::resolve(ref);
 }
 
-Widget * Widget::parseAny(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e)
+std::unordered_map<std::string, WidgetFactory> & Widget::factories()
 {
-    std::string tag(e->Value());
+    static std::unordered_map<std::string, WidgetFactory> factories_ {
 #if WIDGET_BUTTON
-    if(tag == "button") return parse1<Button>(parent, widgets, e);
+        {"button", WidgetFactory{&parseAs<Button>, &cloneAs<Button>}},
 #endif // WIDGET_BUTTON
 #if WIDGET_EDIT
-    if(tag == "edit") return parse1<Edit>(parent, widgets, e);
+        {"edit", WidgetFactory{&parseAs<Edit>, &cloneAs<Edit>}},
 #endif // WIDGET_EDIT
 #if WIDGET_HSLIDER
-    if(tag == "hslider") return parse1<HSlider>(parent, widgets, e);
+        {"hslider", WidgetFactory{&parseAs<HSlider>, &cloneAs<HSlider>}},
 #endif // WIDGET_HSLIDER
 #if WIDGET_VSLIDER
-    if(tag == "vslider") return parse1<VSlider>(parent, widgets, e);
+        {"vslider", WidgetFactory{&parseAs<VSlider>, &cloneAs<VSlider>}},
 #endif // WIDGET_VSLIDER
 #if WIDGET_LABEL
-    if(tag == "label") return parse1<Label>(parent, widgets, e);
+        {"label", WidgetFactory{&parseAs<Label>, &cloneAs<Label>}},
 #endif // WIDGET_LABEL
 #if WIDGET_CHECKBOX
-    if(tag == "checkbox") return parse1<Checkbox>(parent, widgets, e);
+        {"checkbox", WidgetFactory{&parseAs<Checkbox>, &cloneAs<Checkbox>}},
 #endif // WIDGET_CHECKBOX
 #if WIDGET_RADIOBUTTON
-    if(tag == "radiobutton") return parse1<Radiobutton>(parent, widgets, e);
+        {"radiobutton", WidgetFactory{&parseAs<Radiobutton>, &cloneAs<Radiobutton>}},
 #endif // WIDGET_RADIOBUTTON
 #if WIDGET_SPINBOX
-    if(tag == "spinbox") return parse1<Spinbox>(parent, widgets, e);
+        {"spinbox", WidgetFactory{&parseAs<Spinbox>, &cloneAs<Spinbox>}},
 #endif // WIDGET_SPINBOX
 #if WIDGET_COMBOBOX
-    if(tag == "combobox") return parse1<Combobox>(parent, widgets, e);
+        {"combobox", WidgetFactory{&parseAs<Combobox>, &cloneAs<Combobox>}},
 #endif // WIDGET_COMBOBOX
 #if WIDGET_GROUP
-    if(tag == "group") return parse1<Group>(parent, widgets, e);
+        {"group", WidgetFactory{&parseAs<Group>, &cloneAs<Group>}},
 #endif // WIDGET_GROUP
 #if WIDGET_TABS
-    if(tag == "tabs") return parse1<Tabs>(parent, widgets, e);
+        {"tabs", WidgetFactory{&parseAs<Tabs>, &cloneAs<Tabs>}},
 #endif // WIDGET_TABS
-    if(tag == "stretch") return parse1<Stretch>(parent, widgets, e);
+        {"stretch", WidgetFactory{&parseAs<Stretch>, &cloneAs<Stretch>}},
 #if WIDGET_IMAGE
-    if(tag == "image") return parse1<Image>(parent, widgets, e);
+        {"image", WidgetFactory{&parseAs<Image>, &cloneAs<Image>}},
 #endif // WIDGET_IMAGE
 #if WIDGET_PLOT
-    if(tag == "plot") return parse1<Plot>(parent, widgets, e);
+        {"plot", WidgetFactory{&parseAs<Plot>, &cloneAs<Plot>}},
 #endif // WIDGET_PLOT
 #if WIDGET_TABLE
-    if(tag == "table") return parse1<Table>(parent, widgets, e);
+        {"table", WidgetFactory{&parseAs<Table>, &cloneAs<Table>}},
 #endif // WIDGET_TABLE
 #if WIDGET_TREE
-    if(tag == "tree") return parse1<Tree>(parent, widgets, e);
+        {"tree", WidgetFactory{&parseAs<Tree>, &cloneAs<Tree>}},
 #endif // WIDGET_TREE
 #if WIDGET_PROGRESSBAR
-    if(tag == "progressbar") return parse1<Progressbar>(parent, widgets, e);
+        {"progressbar", WidgetFactory{&parseAs<Progressbar>, &cloneAs<Progressbar>}},
 #endif // WIDGET_PROGRESSBAR
 #if WIDGET_TEXTBROWSER
-    if(tag == "text-browser") return parse1<TextBrowser>(parent, widgets, e);
+        {"text-browser", WidgetFactory{&parseAs<TextBrowser>, &cloneAs<TextBrowser>}},
 #endif // WIDGET_TEXTBROWSER
 #if WIDGET_SCENE3D
-    if(tag == "scene3d") return parse1<Scene3D>(parent, widgets, e);
+        {"scene3d", WidgetFactory{&parseAs<Scene3D>, &cloneAs<Scene3D>}},
 #endif // WIDGET_SCENE3D
 #if WIDGET_SVG
-    if(tag == "svg") return parse1<SVG>(parent, widgets, e);
+        {"svg", WidgetFactory{&parseAs<SVG>, &cloneAs<SVG>}},
 #endif // WIDGET_SVG
+    };
+    return factories_;
+}
+
+std::vector<std::string> Widget::getWidgetTypes()
+{
+    std::vector<std::string> ret;
+    for(const auto &x : factories())
+        ret.push_back(x.first);
+    std::sort(ret.begin(), ret.end());
+    return ret;
+}
+
+Widget * Widget::parseAny(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e)
+{
+    auto it = factories().find(e->Value());
+    if(it == factories().end())
+        throw std::range_error((boost::format("invalid element <%s>") % e->Value()).str());
+    return it->second.parse(parent, widgets, e);
+}
 
-    throw std::range_error((boost::format("invalid element <%s>") % tag).str());
+Widget * Widget::cloneAny(const Widget *widget, std::map<int, Widget*>& widgets)
+{
+    auto it = factories().find(widget->widgetClass);
+    if(it == factories().end())
+        throw std::range_error((boost::format("cannot clone element <%s>") % widget->widgetClass).str());
+    return it->second.clone(widget, widgets);
 }
 
 void Widget::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e)
@@ -174,6 +261,24 @@ void Widget::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XM
     enabled = xmlutils::getAttrBool(e, "enabled", true);
 
     visible = xmlutils::getAttrBool(e, "visible", true);
+    mirror_visible = visible;
+
+    coalesceEvents = xmlutils::getAttrBool(e, "coalesce-events", false);
+
+    eventMinInterval = xmlutils::getAttrInt(e, "event-min-interval-ms", 0);
+    if(eventMinInterval < 0)
+        throw std::range_error("event-min-interval-ms must not be negative");
+
+    int eventRateLimit = xmlutils::getAttrInt(e, "event-rate-limit", 0);
+    if(eventRateLimit < 0)
+        throw std::range_error("event-rate-limit must not be negative");
+    if(eventRateLimit > 0)
+        eventMinInterval = std::max(eventMinInterval, std::max(1, 1000 / eventRateLimit));
+
+    std::string eventRateLimitEdge = xmlutils::getAttrStr(e, "event-rate-limit-edge", "both");
+    if(eventRateLimitEdge == "both") eventLeadingEdge = true;
+    else if(eventRateLimitEdge == "trailing") eventLeadingEdge = false;
+    else throw std::range_error("event-rate-limit-edge must be one of: 'both', 'trailing'");
 
     std::string tag(e->Value());
     if(tag != widgetClass)
@@ -181,6 +286,6 @@ void Widget::parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XM
         throw std::range_error((boost::format("element must be <%s>") % widgetClass).str());
     }
 
-    Widget::widgets.insert(this);
+    acquireSlot();
 }
 
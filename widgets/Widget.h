@@ -3,6 +3,8 @@
 
 #include "config.h"
 
+#include <atomic>
+#include <mutex>
 #include <stdexcept>
 #include <vector>
 #include <map>
@@ -10,6 +12,8 @@
 #include <string>
 #include <sstream>
 #include <iostream>
+#include <type_traits>
+#include <unordered_map>
 
 #include <boost/format.hpp>
 
@@ -17,10 +21,33 @@
 
 #include "simPlusPlus/Handle.h"
 
+#include "SlotTable.h"
+
 #include "XMLUtils.h"
 
 class Proxy;
 class UI;
+class LayoutWidget;
+class Tabs;
+struct widget_value;
+
+/**
+ * a reference to a widget (see Widget::getRef), which can be safely passed
+ * across threads and resolved (in constant time) even after the widget has
+ * been deleted (see SlotTable); 0 is the null reference
+ */
+typedef quint64 WidgetRef;
+
+class Widget;
+
+/**
+ * how to parse and clone a widget type (see Widget::parseAny, Widget::cloneAny)
+ */
+struct WidgetFactory
+{
+    Widget * (*parse)(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
+    Widget * (*clone)(const Widget *widget, std::map<int, Widget*>& widgets);
+};
 
 class Widget
 {
@@ -28,11 +55,37 @@ private:
     QWidget *qwidget;
     Proxy *proxy;
     const std::string widgetClass;
+    WidgetRef ref;
 
-protected:
-    static std::map<QWidget *, Widget *> widgetByQWidget;
-    static std::set<Widget *> widgets;
+    // true for the containers, which are always recreated by simUI.update
+    // (see Window::updateStructure):
+    bool container;
+
+    // (SIM thread) number of setter calls which have changed the mirrored
+    // state (see setterChangedMirror), carried by the commands of this widget:
+    quint32 mirrorSeq;
+
+    // (UI thread) the mirrorSeq of the last command executed for this widget,
+    // sent with its value change events, so that SIM can tell an event which
+    // predates a setter, and not overwrite the mirrored state with it (see
+    // SIM::onValueChangeInt):
+    quint32 appliedMirrorSeq;
+
+    // (see SlotTable, getRef)
+    void acquireSlot();
+    void releaseSlot();
+
+    void initClone(std::map<int, Widget*>& widgets);
 
+    template<typename T>
+    static Widget * parseAs(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e) {return parse1<T>(parent, widgets, e);}
+    template<typename T>
+    static Widget * cloneAs(const Widget *widget, std::map<int, Widget*>& widgets) {return clone1(static_cast<const T *>(widget), widgets);}
+
+    // tag -> factory; initialized with the widgets enabled in config.h:
+    static std::unordered_map<std::string, WidgetFactory> & factories();
+
+protected:
     int id;
     struct {
         int x, y, width, height;
@@ -42,10 +95,63 @@ protected:
     bool enabled;
     bool visible;
 
+    // (SIM thread) mirrored state, initialized at parse time:
+    bool mirror_visible;
+
+    // if false, every value change / mouse move event is delivered (see SIM::coalesceEvent):
+    bool coalesceEvents;
+
+    // minimum interval (ms) between two change / mouse move callbacks (0 = no
+    // limit), and whether the first event of a burst is delivered immediately
+    // (see SIM::throttleEvent); key presses are never throttled, as dropping
+    // one would lose a character:
+    int eventMinInterval;
+    bool eventLeadingEdge;
+
+    // the callbacks of this widget, resolved once when the Qt widget is
+    // created (see resolveEventHandlers), so that SIM can dispatch an event
+    // without looking at the widget type; NULL if the widget has no such
+    // event, if the callback is not set, or if the UI has no script:
+    struct
+    {
+        int scriptID;
+        const std::string *onclick;
+        const std::string *onchange;
+        const std::string *oneditingfinished;
+        const std::string *onLinkActivated;
+        const std::string *onKeyPress;
+        const std::string *onMouseDown;
+        const std::string *onMouseUp;
+        const std::string *onMouseMove;
+    } handlers;
+
     Widget(std::string widgetClass);
 
     void setQWidget(QWidget *qwidget);
     void setProxy(Proxy *proxy);
+    void resolveEventHandlers();
+
+    // replaces the children shared with the prototype with copies of them
+    // (see clone1):
+    virtual void cloneChildren(std::map<int, Widget*>& widgets) {}
+
+    // replaces the children found in the given map (see Window::updateStructure):
+    virtual void replaceChildren(const std::unordered_map<Widget*, Widget*> &replacements) {}
+
+    // (SIM thread) to be called by the setters which change the mirrored
+    // state, before enqueuing the command (see mirrorSeq):
+    inline void setterChangedMirror() {mirrorSeq++;}
+
+    // (SIM thread) called when the value of the Qt widget changes, to update
+    // the mirrored state (see SIM::onValueChangeInt, ...); the mirrored state
+    // is kept apart from the parsed attributes, which the Qt widget is created
+    // from (possibly later, in the UI thread, see LayoutWidget::createQtWidgetLazily):
+    virtual void mirrorValueChange(int value) {}
+    virtual void mirrorValueChange(double value) {}
+    virtual void mirrorValueChange(const std::string &value) {}
+
+    // throws if the value is not of the type of the widget (see setMirrorValue):
+    void checkValueType(const widget_value &val, bool isText);
 
 public:
     virtual ~Widget();
@@ -53,22 +159,49 @@ public:
     virtual void parse(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
     virtual QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent) = 0;
 
+    // (SIM thread) the value of the widget, as in simUI.getWidgetValues /
+    // simUI.setWidgetValues (the latter also updates the Qt widget, like the
+    // simUI.setXXXValue function of the widget type); false if the widget
+    // type has no value:
+    virtual bool getMirrorValue(widget_value &val) {return false;}
+    virtual bool setMirrorValue(const widget_value &val, bool suppressEvents) {return false;}
+
+    // (SIM thread) visibility of the widget itself, as set by the visible
+    // attribute or by simUI.setWidgetVisibility:
+    inline void mirrorVisibility(bool visible) {mirror_visible = visible;}
+    inline bool isVisible() {return mirror_visible;}
+
     inline int getId() {return id;}
     inline QWidget * getQWidget() {return qwidget;}
+    inline WidgetRef getRef() {return ref;}
 
     template<typename T>
     static T * parse1(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
     static Widget * parseAny(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
 
+    // returns a copy of a parsed (not yet created) widget and of its children,
+    // which are added to widgets (see TemplateCache):
+    template<typename T>
+    static T * clone1(const T *widget, std::map<int, Widget*>& widgets);
+    static Widget * cloneAny(const Widget *widget, std::map<int, Widget*>& widgets);
+
+    // the tags of all the widgets that can be parsed, sorted:
+    static std::vector<std::string> getWidgetTypes();
+
     static Widget * byId(const std::string &handle, int id, const sim::Handles<Proxy> &handles);
     static Widget * byQWidget(QWidget *w);
 
-    static bool exists(Widget *w);
+    // returns NULL if the widget has been deleted:
+    static Widget * byRef(WidgetRef ref);
+    template<typename T>
+    static T * byRef(WidgetRef ref) {return static_cast<T *>(byRef(ref));}
 
     friend class SIM;
+    friend class Stats;
     friend class UI;
     friend class Window;
     friend class LayoutWidget;
+    friend class Proxy;
 };
 
 template<typename T>
@@ -77,9 +210,12 @@ T * Widget::parse1(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XM
     T *obj = new T;
     try
     {
-        xmlutils::resetKnownAttributes();
+        xmlutils::resetKnownAttributes(e);
         obj->parse(parent, widgets, e);
         xmlutils::reportUnknownAttributes(obj->widgetClass, e);
+        obj->container = std::is_base_of<LayoutWidget, T>::value || std::is_same<Tabs, T>::value;
+        // (the mirrored state set by parse is the initial one)
+        obj->mirrorSeq = 0;
 
         // object parsed successfully
         // now check if ID is duplicate:
@@ -95,10 +231,27 @@ T * Widget::parse1(Widget *parent, std::map<int, Widget*>& widgets, tinyxml2::XM
     }
     catch(std::exception& ex)
     {
+        xmlutils::discardKnownAttributes(e);
         delete obj;
         throw std::range_error((boost::format("%s%s: %s") % e->Value() % (obj->id > 0 ? (boost::format("[id=%d]") % obj->id).str() : std::string("")) % ex.what()).str());
     }
 }
 
+template<typename T>
+T * Widget::clone1(const T *widget, std::map<int, Widget*>& widgets)
+{
+    T *obj = new T(*widget);
+    try
+    {
+        obj->initClone(widgets);
+        return obj;
+    }
+    catch(std::exception& ex)
+    {
+        delete obj;
+        throw;
+    }
+}
+
 #endif // WIDGET_H_INCLUDED
 
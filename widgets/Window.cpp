@@ -4,6 +4,8 @@
 #include "XMLUtils.h"
 
 #include "UI.h"
+#include "SIM.h"
+#include "Proxy.h"
 
 #include "stubs.h"
 
@@ -14,8 +16,6 @@
 
 #include <QDialog>
 
-std::set<Window *> Window::windows;
-
 WindowWidget::WindowWidget()
     : Widget("window")
 {
@@ -27,17 +27,22 @@ QWidget * WindowWidget::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
 }
 
 Window::Window()
-    : qwidget(NULL),
+    : async(false),
+      asyncIsDefault(true),
+      pollEvents(false),
+      qwidget(NULL),
       qwidget_geometry_saved(false),
       visibility_state(true),
-      proxy(NULL)
+      mirror_visible(false),
+      proxy(NULL),
+      ref(0)
 {
     sim::addLog(sim_verbosity_debug, __FUNC__);
 }
 
 Window::~Window()
 {
-    Window::windows.erase(this);
+    SlotTable<Window>::release(ref);
 
     sim::addLog(sim_verbosity_debug, __FUNC__);
 }
@@ -74,17 +79,175 @@ void Window::parse(std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e)
     qwidget_size.setWidth(size[0]);
     qwidget_size.setHeight(size[1]);
 
+    // until the window is created (see simUI.createAsync):
+    mirror_pos = qwidget_pos;
+    mirror_size = qwidget_size;
+
     activate = xmlutils::getAttrBool(e, "activate", true);
 
+    asyncIsDefault = !xmlutils::hasAttr(e, "async");
+    async = xmlutils::getAttrBool(e, "async", SIM::asyncByDefault());
+
+    pollEvents = xmlutils::getAttrBool(e, "poll-events", false);
+
     WindowWidget dummyWidget;
     LayoutWidget::parse(&dummyWidget, &dummyWidget, widgets, e);
 
-    windows.insert(this);
+    ref = SlotTable<Window>::acquire(this);
+}
+
+Window * Window::clone(std::map<int, Widget*>& widgets) const
+{
+    Window *window = new Window(*this);
+    window->ref = 0;
+    try
+    {
+        window->cloneLayout(widgets);
+    }
+    catch(std::exception& ex)
+    {
+        delete window;
+        throw;
+    }
+
+    // the default may have changed since this has been parsed:
+    if(asyncIsDefault)
+        window->async = SIM::asyncByDefault();
+
+    window->ref = SlotTable<Window>::acquire(window);
+    return window;
+}
+
+void Window::updateStructure(Proxy *proxy, UI *ui, Window *window, std::map<int, Widget*>& widgets, const std::set<int> &unchanged)
+{
+    // pair each widget to keep with its copy in the new tree; containers
+    // are always recreated:
+    std::unordered_map<Widget*, Widget*> replacements;
+    std::set<QWidget*> kept;
+    for(const auto &x : widgets)
+    {
+        Widget *newWidget = x.second;
+        if(newWidget->container || unchanged.find(x.first) == unchanged.end()) continue;
+        Widget *oldWidget = proxy->getWidgetById(x.first);
+        if(!oldWidget || !oldWidget->getQWidget()) continue;
+        if(oldWidget->widgetClass != newWidget->widgetClass) continue;
+        // (the visibility may have been changed by a setter)
+        oldWidget->visible = !oldWidget->getQWidget()->isHidden();
+        replacements[newWidget] = oldWidget;
+        replacements[oldWidget] = newWidget;
+        kept.insert(oldWidget->getQWidget());
+    }
+
+    // the kept widgets move to the new tree, and their copies to the old one:
+    replaceInLayout(replacements);
+    window->replaceInLayout(replacements);
+
+    // the Qt widgets of the old tree (but the kept ones) are deleted after
+    // the new ones have been created, so that the kept ones are not deleted
+    // with their container:
+    std::vector<QWidget*> oldQWidgets;
+    for(QWidget *qw : qwidget->findChildren<QWidget*>(QString(), Qt::FindDirectChildrenOnly))
+    {
+        if(Widget::byQWidget(qw) && kept.find(qw) == kept.end())
+            oldQWidgets.push_back(qw);
+    }
+    for(QWidget *qw : kept)
+        qw->setParent(qwidget);
+    delete qwidget->layout();
+
+    std::swap(layout, window->layout);
+    std::swap(contentMargins, window->contentMargins);
+    children.swap(window->children);
+    LayoutWidget::createQtWidget(proxy, ui, qwidget);
+
+    for(QWidget *qw : oldQWidgets)
+        delete qw;
+
+    updateAttributes(proxy, window);
+
+    // now holds the old tree:
+    delete window;
+
+    // the widgets whose creation is deferred (see Proxy::Proxy):
+    for(const auto &x : widgets)
+    {
+        if(!x.second->proxy && replacements.find(x.second) == replacements.end())
+            x.second->setProxy(proxy);
+    }
+}
+
+void Window::updateAttributes(Proxy *proxy, Window *window)
+{
+    // (the SIM thread waits for the update, see SIM::updateStructure)
+    onclose = window->onclose;
+    pollEvents = window->pollEvents;
+    async = window->async;
+    asyncIsDefault = window->asyncIsDefault;
+    proxy->async = async;
+
+    if(window->title != title)
+    {
+        title = window->title;
+        setTitle(title);
+    }
+    if(window->style != style)
+    {
+        style = window->style;
+        qwidget->setStyleSheet(QString::fromStdString(style));
+    }
+    if(window->enabled != enabled)
+    {
+        enabled = window->enabled;
+        qwidget->setEnabled(enabled);
+    }
+    if(window->activate != activate)
+    {
+        activate = window->activate;
+        qwidget->setAttribute(Qt::WA_ShowWithoutActivating, !activate);
+    }
+
+    QDialog *dialog = static_cast<QDialog*>(qwidget);
+    if(window->resizable != resizable || window->closeable != closeable || window->modal != modal)
+    {
+        resizable = window->resizable;
+        closeable = window->closeable;
+        modal = window->modal;
+        // (changing the flags hides the window, and the modality of a
+        // visible window can't be changed)
+        bool visible = dialog->isVisible();
+        dialog->hide();
+        dialog->setWindowFlags(windowFlags());
+        dialog->setModal(modal);
+        if(visible) dialog->show();
+    }
+#if defined(LIN_SIM) || defined(MAC_SIM)
+    // (the size of a window which is not resizable is fixed, see createQtWidget)
+    dialog->setMinimumSize(0, 0);
+    dialog->setMaximumSize(QWIDGETSIZE_MAX, QWIDGETSIZE_MAX);
+#endif
+
+    // the geometry is applied only if set in the new XML; a window hidden by
+    // a scene switch gets it when shown again (see show):
+    bool hidden = qwidget_geometry_saved && dialog->isHidden();
+    placement = window->placement;
+    if(placement == "absolute")
+    {
+        if(hidden) qwidget_pos = window->qwidget_pos;
+        else move(window->qwidget_pos);
+    }
+    if(window->qwidget_size.isValid())
+    {
+        if(hidden) qwidget_size = window->qwidget_size;
+        else resize(window->qwidget_size);
+    }
+#if defined(LIN_SIM) || defined(MAC_SIM)
+    if(!resizable) dialog->setFixedSize(hidden ? qwidget_size : size());
+#endif
 }
 
-bool Window::exists(Window *w)
+Window * Window::byRef(WindowRef ref)
 {
-    return Window::windows.find(w) != Window::windows.end();
+    return SlotTable<Window>::resolve(ref);
 }
 
 #include <QCloseEvent>
@@ -114,7 +277,7 @@ public:
             if(window->onclose != "")
             {
                 event->ignore();
-                UI::getInstance()->windowClose(window);
+                UI::getInstance()->windowClose(window->getRef());
             }
         }
         else QDialog::keyPressEvent(event);
@@ -125,13 +288,47 @@ public:
         if(window->onclose != "")
         {
             event->ignore();
-            UI::getInstance()->windowClose(window);
+            UI::getInstance()->windowClose(window->getRef());
         }
         else
         {
             event->accept();
+            // (still recorded for simUI.pollEvents)
+            if(window->pollEvents)
+                UI::getInstance()->windowClose(window->getRef());
         }
     }
+
+    virtual void showEvent(QShowEvent *event)
+    {
+        QDialog::showEvent(event);
+        notifyStateChange();
+    }
+
+    virtual void hideEvent(QHideEvent *event)
+    {
+        QDialog::hideEvent(event);
+        notifyStateChange();
+    }
+
+    virtual void moveEvent(QMoveEvent *event)
+    {
+        QDialog::moveEvent(event);
+        notifyStateChange();
+    }
+
+    virtual void resizeEvent(QResizeEvent *event)
+    {
+        QDialog::resizeEvent(event);
+        notifyStateChange();
+    }
+
+private:
+    void notifyStateChange()
+    {
+        QRect g = geometry();
+        UI::getInstance()->windowStateChange(window->getRef(), isVisible(), g.x(), g.y(), g.width(), g.height());
+    }
 };
 
 QWidget * Window::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
@@ -141,20 +338,7 @@ QWidget * Window::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     window->setStyleSheet(QString::fromStdString(style));
     LayoutWidget::createQtWidget(proxy, ui, window);
     window->setWindowTitle(QString::fromStdString(title));
-    Qt::WindowFlags flags = Qt::CustomizeWindowHint | Qt::WindowTitleHint | Qt::WindowSystemMenuHint;
-#ifdef MAC_SIM
-    flags |= Qt::Tool;
-#else
-#ifdef LIN_SIM
-    flags |= Qt::Dialog; // Qt::Window doesn't stay above CoppeliaSim's main window since Qt 5.9
-#else
-    flags |= Qt::Dialog;
-#endif
-#endif
-    if(resizable) flags |= Qt::WindowMaximizeButtonHint;
-    else flags |= Qt::MSWindowsFixedSizeDialogHint;
-    if(closeable) flags |= Qt::WindowCloseButtonHint;
-    window->setWindowFlags(flags);
+    window->setWindowFlags(windowFlags());
     window->setModal(modal);
     //window->setAttribute(Qt::WA_DeleteOnClose);
     if(!activate) window->setAttribute(Qt::WA_ShowWithoutActivating);
@@ -186,6 +370,31 @@ QWidget * Window::createQtWidget(Proxy *proxy, UI *ui, QWidget *parent)
     return window;
 }
 
+Qt::WindowFlags Window::windowFlags() const
+{
+    Qt::WindowFlags flags = Qt::CustomizeWindowHint | Qt::WindowTitleHint | Qt::WindowSystemMenuHint;
+#ifdef MAC_SIM
+    flags |= Qt::Tool;
+#else
+#ifdef LIN_SIM
+    flags |= Qt::Dialog; // Qt::Window doesn't stay above CoppeliaSim's main window since Qt 5.9
+#else
+    flags |= Qt::Dialog;
+#endif
+#endif
+    if(resizable) flags |= Qt::WindowMaximizeButtonHint;
+    else flags |= Qt::MSWindowsFixedSizeDialogHint;
+    if(closeable) flags |= Qt::WindowCloseButtonHint;
+    return flags;
+}
+
+void Window::mirrorState()
+{
+    mirror_visible = qwidget->isVisible();
+    mirror_pos = pos();
+    mirror_size = size();
+}
+
 std::string Window::str()
 {
     std::stringstream ss;
@@ -249,10 +458,48 @@ void Window::setTitle(std::string title)
     dialog->setWindowTitle(QString::fromStdString(title));
 }
 
+void Window::mirrorVisibility(bool visible)
+{
+    mirror_visible = visible;
+}
+
+void Window::mirrorPosition(int x, int y)
+{
+    mirror_pos = QPoint(x, y);
+}
+
+void Window::mirrorSize(int w, int h)
+{
+#if defined(LIN_SIM) || defined(MAC_SIM)
+    // window has a fixed size (see createQtWidget)
+    if(!resizable) return;
+#endif
+    mirror_size = QSize(w, h);
+}
+
+void Window::mirrorTitle(std::string title)
+{
+    this->title = title;
+}
+
+bool Window::isVisible()
+{
+    return mirror_visible;
+}
+
+QPoint Window::getPosition()
+{
+    return mirror_pos;
+}
+
+QSize Window::getSize()
+{
+    return mirror_size;
+}
+
 std::string Window::getTitle()
 {
-    QDialog *dialog = static_cast<QDialog*>(getQWidget());
-    return dialog->windowTitle().toStdString();
+    return title;
 }
 
 void Window::setEnabled(bool enabled)
@@ -17,6 +17,13 @@ class UI;
 
 #include "LayoutWidget.h"
 
+/**
+ * a reference to a window (see Window::getRef), which, like WidgetRef, can be
+ * safely passed across threads and resolved even after the window has been
+ * deleted; 0 is the null reference
+ */
+typedef quint64 WindowRef;
+
 class WindowWidget : public Widget
 {
     WindowWidget();
@@ -38,6 +45,10 @@ protected:
     std::string style;
     bool activate;
     std::string placement;
+    bool async;
+    // true if the async attribute is not set (see clone):
+    bool asyncIsDefault;
+    bool pollEvents;
 
     QWidget *qwidget;
 
@@ -47,9 +58,19 @@ protected:
 
     bool visibility_state;
 
+    // state of the Qt window, mirrored in the SIM thread:
+    bool mirror_visible;
+    QPoint mirror_pos;
+    QSize mirror_size;
+
     Proxy *proxy;
 
-    static std::set<Window *> windows;
+    WindowRef ref;
+
+    Qt::WindowFlags windowFlags() const;
+
+    // (see updateStructure):
+    void updateAttributes(Proxy *proxy, Window *window);
 
 public:
     Window();
@@ -57,10 +78,27 @@ public:
 
     virtual void parse(std::map<int, Widget*>& widgets, tinyxml2::XMLElement *e);
     QWidget * createQtWidget(Proxy *proxy, UI *ui, QWidget *parent);
+    // (UI thread, only while the SIM thread is blocked, see UI::onCreate)
+    // copies the state of the Qt window into the mirrored state:
+    void mirrorState();
+
+    // returns a copy of this (parsed, not yet created) window, and of its
+    // widgets, which are added to widgets (see TemplateCache):
+    Window * clone(std::map<int, Widget*>& widgets) const;
+
+    // (UI thread) replaces the contents and the attributes of this (created)
+    // window with those of the given (parsed, not yet created) window, which
+    // is deleted; the widgets whose id is in unchanged (i.e. whose XML element
+    // is the same in the old and in the new XML) and which have the same type
+    // are kept as they are (see simUI.update):
+    void updateStructure(Proxy *proxy, UI *ui, Window *window, std::map<int, Widget*>& widgets, const std::set<int> &unchanged);
 
     std::string str();
 
     inline QWidget * getQWidget() {return qwidget;}
+    inline WindowRef getRef() {return ref;}
+
+    inline bool isAsync() {return async;}
 
     void hide();
     void show();
@@ -71,12 +109,22 @@ public:
     void resize(const QSize &s);
     void resize(int w, int h);
     void setTitle(std::string title);
-    std::string getTitle();
     void setEnabled(bool enabled);
 
+    // (SIM thread) mirrored state:
+    void mirrorVisibility(bool visible);
+    void mirrorPosition(int x, int y);
+    void mirrorSize(int w, int h);
+    void mirrorTitle(std::string title);
+    bool isVisible();
+    QPoint getPosition();
+    QSize getSize();
+    std::string getTitle();
+
     void onSceneChange(int oldSceneID, int newSceneID);
 
-    static bool exists(Window *w);
+    // returns NULL if the window has been deleted:
+    static Window * byRef(WindowRef ref);
 
     friend class UI;
     friend class SIM;